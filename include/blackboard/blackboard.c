@@ -0,0 +1,71 @@
+#include "blackboard/blackboard.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <sched.h>
+#include <sys/mman.h>
+
+// Creates the shared memory segment holding the blackboard. Called only by the
+// master before spawning the other processes.
+struct blackboard *blackboard_create(int drone_count) {
+    int fd = Shm_open(BLACKBOARD_SHM_NAME, O_CREAT | O_RDWR, 0666);
+    Ftruncate(fd, sizeof(struct blackboard));
+    struct blackboard *bb = Mmap(NULL, sizeof(struct blackboard),
+                                 PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    Close(fd);
+
+    // Start from an empty world with the drones in their initial pose
+    memset(bb, 0, sizeof(struct blackboard));
+    bb->drone_count = drone_count;
+    for (int id = 0; id < drone_count; id++)
+        bb->drones[id].state.position = drone_start_position(id, drone_count);
+    return bb;
+}
+
+// Maps the blackboard created by the master in the calling process
+struct blackboard *blackboard_open(void) {
+    int fd = Shm_open(BLACKBOARD_SHM_NAME, O_RDWR, 0666);
+    struct blackboard *bb = Mmap(NULL, sizeof(struct blackboard),
+                                 PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    Close(fd);
+    return bb;
+}
+
+void blackboard_close(struct blackboard *bb) {
+    Munmap(bb, sizeof(struct blackboard));
+}
+
+// Unmaps and removes the shared memory segment, called by the master at exit
+void blackboard_destroy(struct blackboard *bb) {
+    blackboard_close(bb);
+    Shm_unlink(BLACKBOARD_SHM_NAME);
+}
+
+// Copies src into the section. The odd sequence value tells readers that the
+// section is being modified, the release ordering makes the new content
+// visible before the sequence goes back to even.
+void seqlock_write(struct seqlock *lock, void *section, const void *src,
+                   size_t size) {
+    uint32_t seq = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&lock->sequence, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(section, src, size);
+    atomic_store_explicit(&lock->sequence, seq + 2, memory_order_release);
+}
+
+// Copies the section into dst, retrying until the copy is not torn by a
+// concurrent write. No syscall is involved unless the writer is preempted in
+// the middle of an update, in which case the reader yields the CPU.
+void seqlock_read(struct seqlock *lock, const void *section, void *dst,
+                  size_t size) {
+    uint32_t begin, end = 0;
+    do {
+        begin = atomic_load_explicit(&lock->sequence, memory_order_acquire);
+        if (begin & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(dst, section, size);
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    } while ((begin & 1) || begin != end);
+}
@@ -0,0 +1,69 @@
+#ifndef BLACKBOARD_H
+#define BLACKBOARD_H
+
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Sequence lock protecting a section with a single writer. The sequence is odd
+// while the writer is updating the section, readers retry until they copy it
+// between two equal even values.
+struct seqlock {
+    _Atomic uint32_t sequence;
+};
+
+// State of one drone, on its own cache line since every drone writes its slot
+// at every physics step
+struct drone_slot {
+    alignas(64) struct seqlock lock;
+    struct drone_state state;
+};
+
+// Geometrical state of the world shared by all the processes. Every section
+// has exactly one writer:
+// - drone_count: written by the master before spawning the processes
+// - drones: each slot written by its drone at every physics step
+// - targets: written by the map, which owns the target hits
+// - obstacles: written by the obstacle process when it spawns a new set
+// - score: written by the map
+struct blackboard {
+    int drone_count;
+    struct drone_slot drones[MAX_DRONES];
+
+    struct seqlock targets_lock;
+    struct entity_set targets;
+
+    struct seqlock obstacles_lock;
+    struct entity_set obstacles;
+
+    struct seqlock score_lock;
+    int score;
+};
+
+struct blackboard *blackboard_create(int drone_count);
+struct blackboard *blackboard_open(void);
+void blackboard_close(struct blackboard *bb);
+void blackboard_destroy(struct blackboard *bb);
+
+void seqlock_write(struct seqlock *lock, void *section, const void *src,
+                   size_t size);
+void seqlock_read(struct seqlock *lock, const void *section, void *dst,
+                  size_t size);
+
+// Helpers to publish and read each section of the blackboard
+#define BB_PUBLISH(bb, field, src)                                             \
+    seqlock_write(&(bb)->field##_lock, &(bb)->field, (src), sizeof((bb)->field))
+#define BB_SNAPSHOT(bb, field, dst)                                            \
+    seqlock_read(&(bb)->field##_lock, &(bb)->field, (dst), sizeof((bb)->field))
+#define BB_PUBLISH_DRONE(bb, id, src)                                          \
+    seqlock_write(&(bb)->drones[id].lock, &(bb)->drones[id].state, (src),      \
+                  sizeof(struct drone_state))
+#define BB_SNAPSHOT_DRONE(bb, id, dst)                                         \
+    seqlock_read(&(bb)->drones[id].lock, &(bb)->drones[id].state, (dst),       \
+                 sizeof(struct drone_state))
+
+#endif // !BLACKBOARD_H
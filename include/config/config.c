@@ -0,0 +1,321 @@
+#include "config/config.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <cjson/cJSON.h>
+#include <stddef.h>
+#include <sys/inotify.h>
+
+// Type of a parameter in its config struct
+enum config_type {
+    CONFIG_FLOAT,  // Any number
+    CONFIG_INT,    // A whole number
+    CONFIG_BOOL,   // true or false, or a number, true if non zero
+    CONFIG_CHOICE, // One of the strings of choices, stored as its index
+};
+
+// Location and type of a parameter inside a config struct
+struct config_field {
+    const char *name;
+    size_t offset;
+    enum config_type type;
+    const char *const *choices; // NULL terminated, only for CONFIG_CHOICE
+};
+
+// Names of enum integrator in the config file
+static const char *const integrator_names[] = {"implicit_verlet", "verlet",
+                                               "euler", "rk4", NULL};
+
+static const struct config_field drone_fields[] = {
+    {"mass", offsetof(struct drone_config, mass), CONFIG_FLOAT, NULL},
+    {"time_step", offsetof(struct drone_config, time_step), CONFIG_FLOAT,
+     NULL},
+    {"viscous_coefficient",
+     offsetof(struct drone_config, viscous_coefficient), CONFIG_FLOAT, NULL},
+    {"reading_params_interval",
+     offsetof(struct drone_config, reading_params_interval), CONFIG_FLOAT,
+     NULL},
+    {"area_of_effect", offsetof(struct drone_config, area_of_effect),
+     CONFIG_FLOAT, NULL},
+    {"targ_of_effect", offsetof(struct drone_config, targ_of_effect),
+     CONFIG_FLOAT, NULL},
+    {"obst_of_effect", offsetof(struct drone_config, obst_of_effect),
+     CONFIG_FLOAT, NULL},
+    {"function_scale", offsetof(struct drone_config, function_scale),
+     CONFIG_FLOAT, NULL},
+    {"integrator", offsetof(struct drone_config, integrator), CONFIG_CHOICE,
+     integrator_names},
+    {"substep_tolerance", offsetof(struct drone_config, substep_tolerance),
+     CONFIG_FLOAT, NULL},
+    {"max_substeps", offsetof(struct drone_config, max_substeps), CONFIG_INT,
+     NULL},
+    {"field_cache", offsetof(struct drone_config, field_cache), CONFIG_BOOL,
+     NULL},
+    {"static_field", offsetof(struct drone_config, static_field), CONFIG_BOOL,
+     NULL},
+};
+
+static const struct config_field input_fields[] = {
+    {"max_force", offsetof(struct input_config, max_force), CONFIG_FLOAT,
+     NULL},
+    {"force_step", offsetof(struct input_config, force_step), CONFIG_FLOAT,
+     NULL},
+    {"reading_params_interval",
+     offsetof(struct input_config, reading_params_interval), CONFIG_FLOAT,
+     NULL},
+};
+
+static const struct config_field map_fields[] = {
+    {"target_fps", offsetof(struct map_config, target_fps), CONFIG_FLOAT,
+     NULL},
+    {"reading_params_interval",
+     offsetof(struct map_config, reading_params_interval), CONFIG_FLOAT,
+     NULL},
+};
+
+// Reads the whole config file, whatever its size. The returned buffer must be
+// freed by the caller, NULL is returned on error.
+static char *config_read_file(void) {
+    FILE *config_file = fopen(CONFIG_PATH, "r");
+    if (config_file == NULL) {
+        logging("ERROR", "Error opening the config file " CONFIG_PATH);
+        return NULL;
+    }
+
+    fseek(config_file, 0, SEEK_END);
+    long size = ftell(config_file);
+    if (size < 0) {
+        logging("ERROR", "Error measuring the config file " CONFIG_PATH);
+        fclose(config_file);
+        return NULL;
+    }
+    rewind(config_file);
+
+    char *buffer = malloc(size + 1);
+    if (buffer == NULL) {
+        logging("ERROR", "Error allocating the config file " CONFIG_PATH);
+        fclose(config_file);
+        return NULL;
+    }
+    size_t read = fread(buffer, 1, size, config_file);
+    fclose(config_file);
+    buffer[read] = '\0';
+    return buffer;
+}
+
+static bool config_parse_number(const cJSON *param_obj,
+                                const struct config_field *field,
+                                char *parsed) {
+    if (!param_obj || !cJSON_IsNumber(param_obj)) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Error parameter not found or not a number: %s",
+                field->name);
+        logging("ERROR", logmsg);
+        return false;
+    }
+    float value = (float)param_obj->valuedouble;
+    memcpy(parsed + field->offset, &value, sizeof(value));
+    return true;
+}
+
+// cJSON saturates valueint, so a number equal to it is a whole number in the
+// range of an int
+static bool config_parse_int(const cJSON *param_obj,
+                             const struct config_field *field, char *parsed) {
+    if (!param_obj || !cJSON_IsNumber(param_obj) ||
+        param_obj->valuedouble != param_obj->valueint) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Error parameter not found or not an integer: %s",
+                field->name);
+        logging("ERROR", logmsg);
+        return false;
+    }
+    memcpy(parsed + field->offset, &param_obj->valueint, sizeof(int));
+    return true;
+}
+
+static bool config_parse_bool(const cJSON *param_obj,
+                              const struct config_field *field, char *parsed) {
+    bool value;
+    if (param_obj && cJSON_IsBool(param_obj)) {
+        value = cJSON_IsTrue(param_obj);
+    } else if (param_obj && cJSON_IsNumber(param_obj)) {
+        value = param_obj->valuedouble != 0;
+    } else {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Error parameter not found or not a boolean: %s",
+                field->name);
+        logging("ERROR", logmsg);
+        return false;
+    }
+    memcpy(parsed + field->offset, &value, sizeof(value));
+    return true;
+}
+
+static bool config_parse_choice(const cJSON *param_obj,
+                                const struct config_field *field,
+                                char *parsed) {
+    if (param_obj && cJSON_IsString(param_obj)) {
+        for (int index = 0; field->choices[index]; index++) {
+            if (strcmp(param_obj->valuestring, field->choices[index]) == 0) {
+                memcpy(parsed + field->offset, &index, sizeof(index));
+                return true;
+            }
+        }
+    }
+    char logmsg[MAX_STR_LEN];
+    sprintf(logmsg, "Error parameter not found or not a valid name: %s",
+            field->name);
+    logging("ERROR", logmsg);
+    return false;
+}
+
+// Parses one section of the config file into out. Every field must be found
+// for the parsing to succeed, out is left untouched otherwise.
+static bool config_load(const char *section, const struct config_field *fields,
+                        int fields_num, void *out, size_t out_size) {
+    char *buffer = config_read_file();
+    if (buffer == NULL)
+        return false;
+
+    cJSON *json = cJSON_Parse(buffer);
+    free(buffer);
+    if (json == NULL) {
+        logging("ERROR", "Error parsing the config file " CONFIG_PATH);
+        return false;
+    }
+
+    // Fill a copy so that a partially valid file never reaches the caller
+    char parsed[out_size];
+    memcpy(parsed, out, out_size);
+
+    bool ok            = true;
+    cJSON *section_obj = cJSON_GetObjectItem(json, section);
+    if (!section_obj) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Error process not found: %s", section);
+        logging("ERROR", logmsg);
+        ok = false;
+    }
+    for (int i = 0; ok && i < fields_num; i++) {
+        cJSON *param_obj = cJSON_GetObjectItem(section_obj, fields[i].name);
+        switch (fields[i].type) {
+        case CONFIG_FLOAT:
+            ok = config_parse_number(param_obj, &fields[i], parsed);
+            break;
+        case CONFIG_INT:
+            ok = config_parse_int(param_obj, &fields[i], parsed);
+            break;
+        case CONFIG_BOOL:
+            ok = config_parse_bool(param_obj, &fields[i], parsed);
+            break;
+        case CONFIG_CHOICE:
+            ok = config_parse_choice(param_obj, &fields[i], parsed);
+            break;
+        }
+    }
+    cJSON_Delete(json);
+
+    if (ok)
+        memcpy(out, parsed, out_size);
+    return ok;
+}
+
+// Logs and rejects a parameter that must be strictly positive
+static bool config_check_positive(const char *name, float value) {
+    if (value > 0)
+        return true;
+    char logmsg[MAX_STR_LEN];
+    sprintf(logmsg, "Error parameter must be positive: %s", name);
+    logging("ERROR", logmsg);
+    return false;
+}
+
+// The parameters used as divisors and max_substeps are range checked as well,
+// config is left untouched if any of them is out of range.
+bool config_load_drone(struct drone_config *config) {
+    struct drone_config loaded = *config;
+    if (!config_load("drone", drone_fields,
+                     sizeof(drone_fields) / sizeof(drone_fields[0]), &loaded,
+                     sizeof(loaded)))
+        return false;
+
+    if (!config_check_positive("mass", loaded.mass) ||
+        !config_check_positive("time_step", loaded.time_step) ||
+        !config_check_positive("reading_params_interval",
+                               loaded.reading_params_interval))
+        return false;
+    if (loaded.max_substeps < 1) {
+        logging("ERROR", "Error parameter must be at least 1: max_substeps");
+        return false;
+    }
+
+    *config = loaded;
+    return true;
+}
+
+bool config_load_input(struct input_config *config) {
+    return config_load("input", input_fields,
+                       sizeof(input_fields) / sizeof(input_fields[0]), config,
+                       sizeof(*config));
+}
+
+bool config_load_map(struct map_config *config) {
+    return config_load("map", map_fields,
+                       sizeof(map_fields) / sizeof(map_fields[0]), config,
+                       sizeof(*config));
+}
+
+static struct timespec config_mtime(void) {
+    struct stat st;
+    struct timespec none = {0, 0};
+    if (stat(CONFIG_PATH, &st) < 0)
+        return none;
+    return st.st_mtim;
+}
+
+// Starts watching the config file. The directory is watched instead of the
+// file because editors usually replace the file instead of rewriting it.
+void config_watch_init(struct config_watch *watch) {
+    watch->mtime = config_mtime();
+    watch->ifd   = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->ifd < 0)
+        return;
+
+    if (inotify_add_watch(watch->ifd, CONFIG_DIR,
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        close(watch->ifd);
+        watch->ifd = -1;
+    }
+}
+
+// Returns true if the config file changed since the previous call. Costs a
+// single non-blocking syscall when nothing changed.
+bool config_changed(struct config_watch *watch) {
+    if (watch->ifd < 0) {
+        struct timespec mtime = config_mtime();
+        bool changed          = mtime.tv_sec != watch->mtime.tv_sec ||
+                       mtime.tv_nsec != watch->mtime.tv_nsec;
+        watch->mtime          = mtime;
+        return changed;
+    }
+
+    // Consume every pending event, looking for the config file among them
+    char events[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t len;
+    while ((len = read(watch->ifd, events, sizeof(events))) > 0) {
+        for (char *ptr = events; ptr < events + len;) {
+            struct inotify_event *event = (struct inotify_event *)ptr;
+            if (event->len > 0 && strcmp(event->name, CONFIG_FILE) == 0)
+                changed = true;
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+void config_watch_close(struct config_watch *watch) {
+    if (watch->ifd >= 0)
+        Close(watch->ifd);
+}
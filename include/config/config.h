@@ -0,0 +1,66 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdbool.h>
+#include <time.h>
+
+// Integration schemes of the drone dynamics, see physics_step
+enum integrator {
+    INTEGRATOR_IMPLICIT_VERLET, // Verlet with implicit drag, the default
+    INTEGRATOR_VERLET,          // Explicit Verlet
+    INTEGRATOR_EULER,           // Semi-implicit (symplectic) Euler
+    INTEGRATOR_RK4,             // Classic fourth order Runge-Kutta
+    INTEGRATOR_COUNT
+};
+
+// Parameters of the drone section of drone_parameters.json
+struct drone_config {
+    float mass;
+    float time_step;
+    float viscous_coefficient;
+    float reading_params_interval;
+    float area_of_effect;
+    float targ_of_effect;
+    float obst_of_effect;
+    float function_scale;
+    int integrator; // enum integrator
+    // A step is split in substeps of at most substep_tolerance times the
+    // clearance to the walls and obstacles, and at most max_substeps (at least
+    // 1) of them. A substep_tolerance of 0 disables the substepping.
+    float substep_tolerance;
+    int max_substeps;
+    // Read the force profiles from lookup tables, see lut.h
+    bool field_cache;
+    // Sample the walls and obstacles from a rasterized field, see potential.h
+    bool static_field;
+};
+
+// Parameters of the input section of drone_parameters.json
+struct input_config {
+    float max_force;
+    float force_step;
+    float reading_params_interval;
+};
+
+// Parameters of the map section of drone_parameters.json
+struct map_config {
+    float target_fps;
+    float reading_params_interval;
+};
+
+// Change detector of the config file. inotify is used when available,
+// otherwise the modification time of the file is compared.
+struct config_watch {
+    int ifd;
+    struct timespec mtime;
+};
+
+bool config_load_drone(struct drone_config *config);
+bool config_load_input(struct input_config *config);
+bool config_load_map(struct map_config *config);
+
+void config_watch_init(struct config_watch *watch);
+bool config_changed(struct config_watch *watch);
+void config_watch_close(struct config_watch *watch);
+
+#endif // !CONFIG_H
@@ -4,18 +4,27 @@
 #define NUM_PROCESSES 7
 
 #define LOGFILE_PATH "../log/process.log"
+#define TELEMETRY_LOG_PATH "../log/telemetry.csv"
+#define CONFIG_DIR "../config"
+#define CONFIG_FILE "drone_parameters.json"
+#define CONFIG_PATH CONFIG_DIR "/" CONFIG_FILE
 #define FIFO1_PATH "./fifo_one"
 #define FIFO2_PATH "./fifo_two"
+#define BLACKBOARD_SHM_NAME "/drone_blackboard"
+#define CHANNELS_SHM_NAME "/drone_channels"
 
 #define SIMULATION_WIDTH 400
 #define SIMULATION_HEIGHT 400
 #define ZERO_THRESHOLD 0.1
 
 #define MAX_STR_LEN 300
-#define MAX_MSG_LEN 1024
 
 #define N_TARGETS 9
 #define N_OBSTACLES 10
+// Capacity of the sets exchanged in a single message, and so of the entity
+// stores and grids of the drones. A set has to fit the 16-bit length of a
+// frame and a ring, which bounds it to about 2000 entities.
+#define MAX_ENTITIES (N_TARGETS > N_OBSTACLES ? N_TARGETS : N_OBSTACLES)
 
 // Maximum combined force from the obstacles
 #define MAX_OBST_FORCES 1000
@@ -25,8 +34,60 @@
 #define INIT_POSE_X 200
 #define INIT_POSE_Y 200
 
+// Maximum number of drones, the number is chosen at launch
+#define MAX_DRONES 256
+// Radius of the circle around the initial pose where the other drones start
+#define DRONE_SPAWN_RADIUS 100
+
 #define OBSTACLES_SPAWN_PERIOD 20
 
+// Maximum number of physics steps run back to back by a late drone to catch up
+// with its deadlines, the missed time beyond is dropped
+#define MAX_CATCHUP_STEPS 5
+
+// Period of the input loop in seconds, one key is read per period. The input
+// display keeps a pressed key highlighted for one period.
+#define INPUT_PERIOD 0.1
+
+// Collision response of the drone, see physics_step. The drone stays
+// WALL_MARGIN away from the borders, where the wall force is still finite,
+// and out of a disc of OBSTACLE_RADIUS around each obstacle. The normal
+// velocity is reversed and scaled by COLLISION_RESTITUTION on impact, 0
+// stopping the drone against the surface, 1 being a perfect bounce.
+#define WALL_MARGIN 1
+#define OBSTACLE_RADIUS 2
+#define COLLISION_RESTITUTION 0.5
+// Maximum number of impacts resolved in a single step, the drone stops at
+// the last one beyond
+#define MAX_COLLISIONS 4
+
+// Distance from a target within which a drone hits it, in simulation units
+#define HIT_RADIUS 5
+
+// Keys played by the input driver in headless mode when no script is given,
+// one per INPUT_PERIOD, '.' meaning no key
+#define HEADLESS_DEFAULT_SCRIPT                                                \
+    "dddd..........xxxx..........aaaaaaaa..........wwwwwwww..........s....."
+
+// Period of the default frame rate of the map (30 FPS). The map itself
+// follows target_fps of the config file.
+#define MAP_FRAME_PERIOD_US 33333
+
+// Minimum period between two batches relayed by the server to the drone and to
+// the map. Only the newest state is kept in between.
+#define RELAY_DRONE_PERIOD_US 10000
+#define RELAY_MAP_PERIOD_US MAP_FRAME_PERIOD_US
+
+// Period at which the input display checks the telemetry of the selected drone
+// and the score, drawing them again only if they changed
+#define INPUT_TELEMETRY_PERIOD_US MAP_FRAME_PERIOD_US
+
+// Shortest period of a telemetry subscription, shorter ones are raised to it
+#define TELEMETRY_MIN_PERIOD_US 1000
+
+// Period of the telemetry written by the recorder
+#define RECORDER_PERIOD_US 100000
+
 // Defining the amount to sleep between any two consequent signals to the
 // processes
 #define WD_SLEEP_PERIOD 1
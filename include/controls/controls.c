@@ -0,0 +1,76 @@
+#include "controls/controls.h"
+
+// Calculates the diagonal length of a square given its side length.
+// Uses a precomputed value for sqrt(2)/2 (0.7071) to optimize performance.
+float diag(float side) {
+    const float sqrt2_half = 0.7071; // Precomputed value for sqrt(2)/2
+    return side * sqrt2_half;
+}
+
+// Reduces the force to zero, effectively stopping movement.
+float slow_down(void) {
+    return 0.0f;
+}
+
+// Updates the force applied to the drone based on user input.
+// Returns true if the input is recognized, false otherwise.
+bool update_force(struct force *to_update, int input, float step, float max_force) {
+    /*
+     * Coordinate system:
+     *                     X
+     *           +--------->
+     *           |
+     *           |
+     *         Y |
+     *           V
+     */
+    bool ret = true;
+
+    // Adjust force based on the input key
+    switch (input) {
+        case 'q': // Top-left diagonal
+            to_update->x_component -= diag(step);
+            to_update->y_component -= diag(step);
+            break;
+        case 'w': // Up
+            to_update->y_component -= step;
+            break;
+        case 'e': // Top-right diagonal
+            to_update->x_component += diag(step);
+            to_update->y_component -= diag(step);
+            break;
+        case 'a': // Left
+            to_update->x_component -= step;
+            break;
+        case 's': // Stop (reset force)
+        case ' ':
+            to_update->x_component = slow_down();
+            to_update->y_component = slow_down();
+            break;
+        case 'd': // Right
+            to_update->x_component += step;
+            break;
+        case 'z': // Bottom-left diagonal
+            to_update->x_component -= diag(step);
+            to_update->y_component += diag(step);
+            break;
+        case 'x': // Down
+            to_update->y_component += step;
+            break;
+        case 'c': // Bottom-right diagonal
+            to_update->x_component += diag(step);
+            to_update->y_component += diag(step);
+            break;
+        default: // Invalid input
+            ret = false;
+            break;
+    }
+
+    // Clamp force components within the maximum limits
+    if (to_update->x_component > max_force) to_update->x_component = max_force;
+    if (to_update->y_component > max_force) to_update->y_component = max_force;
+    if (to_update->x_component < -max_force) to_update->x_component = -max_force;
+    if (to_update->y_component < -max_force) to_update->y_component = -max_force;
+
+    return ret;
+}
@@ -0,0 +1,12 @@
+#ifndef CONTROLS_H
+#define CONTROLS_H
+
+#include "droneDataStructs.h"
+#include <stdbool.h>
+
+float diag(float side);
+float slow_down(void);
+bool update_force(struct force *to_update, int input, float step,
+                  float max_force);
+
+#endif // !CONTROLS_H
@@ -16,4 +16,9 @@ struct velocity {
     float y_component;
 };
 
+struct drone_state {
+    struct pos position;
+    struct velocity velocity;
+};
+
 #endif
@@ -0,0 +1,154 @@
+#include "engine/engine.h"
+#include "spawn/spawn.h"
+#include "utility/utility.h"
+#include <math.h>
+
+// Frames handled by the drone, same as the loop of drone.c
+static void drone_receive(struct engine *engine, const struct msg *frame) {
+    switch (frame->header.type) {
+        case MSG_FORCE:
+            engine->drone_force = frame->payload.force;
+            break;
+
+        case MSG_TARGETS:
+            store_load(&engine->targets, frame->payload.set.items,
+                       frame->payload.set.count);
+            grid_build(&engine->targets_grid, &engine->targets,
+                       engine->params.targ_of_effect);
+            break;
+
+        case MSG_OBSTACLES:
+            store_load(&engine->obstacles, frame->payload.set.items,
+                       frame->payload.set.count);
+            grid_build(&engine->obstacles_grid, &engine->obstacles,
+                       engine->params.obst_of_effect);
+            break;
+
+        case MSG_TARGET_HIT: {
+            const struct target_hit *hit = &frame->payload.hit;
+            int index                    = hit->index;
+            if (index >= engine->targets.count ||
+                engine->targets.x[index] != hit->position.x ||
+                engine->targets.y[index] != hit->position.y) {
+                logging("ERROR", "Mismatched target and array in engine");
+            } else {
+                store_remove(&engine->targets, index);
+                grid_remove(&engine->targets_grid, index);
+            }
+            break;
+        }
+    }
+}
+
+// Frames handled by the map: only the targets matter for the score
+static void map_receive(struct engine *engine, const struct msg *frame) {
+    if (frame->header.type == MSG_TARGETS) {
+        engine->target_num = frame->payload.set.count;
+        memcpy(engine->targets_pos, frame->payload.set.items,
+               engine->target_num * sizeof(struct pos));
+        scoring_new_targets(&engine->keeper, engine->now);
+        engine->target_sets++;
+    }
+}
+
+// The target and obstacle generators send a whole new set
+static void generate(struct engine *engine, enum endpoint from,
+                     uint16_t type, int count) {
+    struct entity_set set;
+    spawn_entities(&set, count, &engine->seed);
+    engine_send(engine, from, type, &set, ENTITY_SET_SIZE(set.count));
+}
+
+// Places the drone at its initial position and generates the first targets
+// and obstacles, as the processes do when they start
+void engine_init(struct engine *engine, const struct drone_config *params,
+                 unsigned int seed) {
+    double T             = params->time_step;
+    engine->params       = *params;
+    engine->seed         = seed;
+    engine->steps        = 0;
+    engine->now          = 0;
+    engine->spawn_period = fmax(round(OBSTACLES_SPAWN_PERIOD / T), 1);
+    engine->stopped      = false;
+
+    // Drone still at its initial position, with no target nor obstacle
+    physics_init(&engine->body, INIT_POSE_X, INIT_POSE_Y);
+    luts_init(&engine->luts);
+    luts_update(&engine->luts, &engine->params);
+    engine->drone_force.x_component = engine->drone_force.y_component = 0;
+
+    engine->targets.count = engine->obstacles.count = 0;
+    grid_build(&engine->targets_grid, &engine->targets,
+               engine->params.targ_of_effect);
+    grid_build(&engine->obstacles_grid, &engine->obstacles,
+               engine->params.obst_of_effect);
+
+    scoring_init(&engine->keeper, engine->now);
+    engine->target_num  = 0;
+    engine->target_sets = 0;
+
+    generate(engine, EP_OBSTACLE, MSG_OBSTACLES, N_OBSTACLES);
+    generate(engine, EP_TARGET, MSG_TARGETS, N_TARGETS);
+}
+
+// Sends a frame on behalf of an endpoint. It is delivered immediately to the
+// endpoints chosen by the routing table of the server.
+void engine_send(struct engine *engine, enum endpoint from, uint16_t type,
+                 const void *payload, uint16_t length) {
+    struct msg frame;
+    frame.header.type   = type;
+    frame.header.length = length;
+    frame.header.drone  = DRONE_ALL;
+    if (length > 0)
+        memcpy(&frame.payload, payload, length);
+
+    unsigned int to = route_frame(from, type);
+    if (to & ROUTE_TO(EP_DRONE))
+        drone_receive(engine, &frame);
+    if (to & ROUTE_TO(EP_MAP))
+        map_receive(engine, &frame);
+    if ((to & ROUTE_TO(EP_TARGET)) && type == MSG_GENERATE)
+        generate(engine, EP_TARGET, MSG_TARGETS, N_TARGETS);
+
+    if (type == MSG_STOP)
+        engine->stopped = true;
+}
+
+// Advances the simulation by one time step of the drone
+void engine_step(struct engine *engine) {
+    if (engine->stopped)
+        return;
+
+    // Obstacles: a new set every spawn period
+    if (engine->steps > 0 && engine->steps % engine->spawn_period == 0)
+        generate(engine, EP_OBSTACLE, MSG_OBSTACLES, N_OBSTACLES);
+
+    // Drone
+    struct pos previous_pos = engine->body.position;
+    physics_step(&engine->body, &engine->params, engine->drone_force,
+                 &engine->obstacles_grid, &engine->targets_grid,
+                 &engine->luts, NULL);
+    engine->steps++;
+    engine->now = engine->steps * engine->params.time_step;
+
+    // Map: every target the drone passed within the hit radius of during the
+    // step is reached, in the order it was reached
+    struct pos drone_pos = engine->body.position;
+    bool to_decrease     = false;
+    int i;
+    while ((i = find_swept_hit(engine->targets_pos, engine->target_num,
+                               previous_pos, drone_pos, HIT_RADIUS)) >= 0) {
+        scoring_target_hit(&engine->keeper, i, engine->now);
+
+        struct target_hit hit = {i, engine->targets_pos[i]};
+        remove_target(i, engine->targets_pos, engine->target_num);
+        engine->target_num--;
+        engine_send(engine, EP_MAP, MSG_TARGET_HIT, &hit, sizeof(hit));
+        to_decrease = true;
+    }
+    scoring_wall(&engine->keeper, drone_pos, engine->now);
+
+    // If all targets have been hit, request new ones
+    if (to_decrease && engine->target_num == 0)
+        engine_send(engine, EP_MAP, MSG_GENERATE, NULL, 0);
+}
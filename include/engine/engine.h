@@ -0,0 +1,47 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "config/config.h"
+#include "forces/forces.h"
+#include "grid/grid.h"
+#include "physics/physics.h"
+#include "protocol/protocol.h"
+#include "routing/routing.h"
+#include "scoring/scoring.h"
+#include <stdbool.h>
+
+// The drone, the map scoring and the target and obstacle generators stepped
+// in a single process on a simulated clock. Their frames are routed with the
+// table of the server but delivered by direct function calls, and time only
+// advances in engine_step, so nothing ever sleeps.
+struct engine {
+    struct drone_config params;
+    unsigned int seed; // State of the target and obstacle generators
+    long steps;        // Steps run since the start
+    double now;        // Simulated time in seconds
+    long spawn_period; // Steps between two sets of obstacles
+    bool stopped;      // STOP has been delivered
+
+    // Drone
+    struct drone_body body;
+    struct force drone_force;
+    struct entity_store targets;
+    struct entity_store obstacles;
+    struct spatial_grid targets_grid;
+    struct spatial_grid obstacles_grid;
+    struct force_luts luts;
+
+    // Map
+    struct score_keeper keeper;
+    struct pos targets_pos[N_TARGETS];
+    int target_num;
+    int target_sets; // Sets of targets received, the first one included
+};
+
+void engine_init(struct engine *engine, const struct drone_config *params,
+                 unsigned int seed);
+void engine_send(struct engine *engine, enum endpoint from, uint16_t type,
+                 const void *payload, uint16_t length);
+void engine_step(struct engine *engine);
+
+#endif // !ENGINE_H
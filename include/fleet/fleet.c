@@ -0,0 +1,227 @@
+#include "fleet/fleet.h"
+#include "utility/utility.h"
+#include <limits.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+// Empty obstacle and target sets, indexed with the effect radii
+void world_init(struct world_snapshot *world,
+                const struct drone_config *params) {
+    world->targets.count = world->obstacles.count = 0;
+    luts_init(&world->luts);
+    world->potential         = NULL;
+    world->obstacles_version = 0;
+    world_reindex(world, params);
+}
+
+void world_set_targets(struct world_snapshot *world, const struct pos *items,
+                       int count, const struct drone_config *params) {
+    store_load(&world->targets, items, count);
+    grid_build(&world->targets_grid, &world->targets, params->targ_of_effect);
+}
+
+void world_set_obstacles(struct world_snapshot *world, const struct pos *items,
+                         int count, const struct drone_config *params) {
+    store_load(&world->obstacles, items, count);
+    grid_build(&world->obstacles_grid, &world->obstacles,
+               params->obst_of_effect);
+    world->obstacles_version++;
+}
+
+// Removes a hit target, returns false if it is not at the given index
+bool world_remove_target(struct world_snapshot *world, int index,
+                         struct pos position) {
+    if (index >= world->targets.count ||
+        world->targets.x[index] != position.x ||
+        world->targets.y[index] != position.y)
+        return false;
+    store_remove(&world->targets, index);
+    grid_remove(&world->targets_grid, index);
+    return true;
+}
+
+// Rebuilds the grids, whose cell size follows the effect radii, and the force
+// tables if their parameters changed
+void world_reindex(struct world_snapshot *world,
+                   const struct drone_config *params) {
+    grid_build(&world->targets_grid, &world->targets, params->targ_of_effect);
+    grid_build(&world->obstacles_grid, &world->obstacles,
+               params->obst_of_effect);
+    luts_update(&world->luts, params);
+    world->obstacles_version++;
+}
+
+// Spinning only helps when every thread has its own core, otherwise it takes
+// the core of the thread being waited for
+static void barrier_init(struct fleet_barrier *barrier, int parties) {
+    atomic_init(&barrier->arrived, 0);
+    atomic_init(&barrier->generation, 0);
+    atomic_init(&barrier->sleepers, 0);
+    atomic_init(&barrier->parties, parties);
+    barrier->spin = parties <= sysconf(_SC_NPROCESSORS_ONLN) ? FLEET_SPIN : 0;
+}
+
+static void barrier_wait(struct fleet_barrier *barrier) {
+    unsigned int generation = atomic_load(&barrier->generation);
+    if (atomic_fetch_add(&barrier->arrived, 1) == barrier->parties - 1) {
+        // Last one: nobody else can arrive before the new generation starts
+        atomic_store(&barrier->arrived, 0);
+        atomic_fetch_add(&barrier->generation, 1);
+        if (atomic_load(&barrier->sleepers) > 0)
+            syscall(SYS_futex, &barrier->generation, FUTEX_WAKE_PRIVATE,
+                    INT_MAX, NULL, NULL, 0);
+        return;
+    }
+
+    for (int i = 0; i < barrier->spin; i++) {
+        if (atomic_load_explicit(&barrier->generation,
+                                 memory_order_acquire) != generation)
+            return;
+        cpu_relax();
+    }
+
+    // The futex sleeps only if the generation has not changed in between,
+    // and the last thread sees the sleeper once it has changed it
+    atomic_fetch_add(&barrier->sleepers, 1);
+    while (atomic_load(&barrier->generation) == generation)
+        syscall(SYS_futex, &barrier->generation, FUTEX_WAIT_PRIVATE,
+                generation, NULL, NULL, 0);
+    atomic_fetch_sub(&barrier->sleepers, 1);
+}
+
+// Claims the next chunk of a queue, returns its first drone or -1 if the
+// queue is empty
+static int claim_chunk(struct fleet_queue *queue) {
+    if (atomic_load_explicit(&queue->next, memory_order_relaxed) >= queue->end)
+        return -1;
+    int first = atomic_fetch_add_explicit(&queue->next, FLEET_CHUNK,
+                                          memory_order_relaxed);
+    return first < queue->end ? first : -1;
+}
+
+static void step_chunk(struct fleet *fleet, int first, int end) {
+    const struct world_snapshot *world = fleet->world;
+    for (int id = first; id < end; id++) {
+        physics_step(&fleet->bodies[id], fleet->params, fleet->forces[id],
+                     &world->obstacles_grid, &world->targets_grid,
+                     &world->luts, world->potential);
+        if (fleet->publish)
+            fleet->publish(fleet->context, id, &fleet->bodies[id]);
+    }
+}
+
+// Steps the chunks of its own queue, then steals the chunks left in the
+// queues of the slower workers
+static void run_tick(struct fleet *fleet, int worker) {
+    for (int k = 0; k < fleet->threads; k++) {
+        struct fleet_queue *queue =
+            &fleet->queues[(worker + k) % fleet->threads];
+        int first;
+        while ((first = claim_chunk(queue)) >= 0) {
+            int end = first + FLEET_CHUNK;
+            step_chunk(fleet, first, end < queue->end ? end : queue->end);
+        }
+    }
+}
+
+static void *worker_loop(void *arg) {
+    struct fleet_worker *self = arg;
+    struct fleet *fleet       = self->fleet;
+    int worker                = self->index;
+    while (1) {
+        barrier_wait(&fleet->start);
+        if (fleet->stopping)
+            break;
+        run_tick(fleet, worker);
+        barrier_wait(&fleet->done);
+    }
+    return NULL;
+}
+
+// Places the drones still at their start positions and starts threads - 1
+// workers. If a thread cannot be created the fleet runs with fewer.
+void fleet_init(struct fleet *fleet, int count, int threads) {
+    fleet->count    = count;
+    fleet->world    = NULL;
+    fleet->params   = NULL;
+    fleet->publish  = NULL;
+    fleet->context  = NULL;
+    fleet->stopping = false;
+    for (int id = 0; id < count; id++) {
+        struct pos start = drone_start_position(id, count);
+        physics_init(&fleet->bodies[id], start.x, start.y);
+        fleet->forces[id].x_component = fleet->forces[id].y_component = 0;
+    }
+
+    if (threads > FLEET_MAX_THREADS)
+        threads = FLEET_MAX_THREADS;
+    if (threads < 1)
+        threads = 1;
+
+    // The workers block every signal, so that the watchdog pings keep being
+    // delivered to the main thread
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int started = 1;
+    barrier_init(&fleet->start, threads);
+    barrier_init(&fleet->done, threads);
+    for (; started < threads; started++) {
+        struct fleet_worker *worker = &fleet->workers[started];
+        worker->fleet               = fleet;
+        worker->index               = started;
+        if (pthread_create(&worker->thread, NULL, worker_loop, worker) != 0) {
+            logging("WARN", "Fleet could not start all its threads");
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    // The workers already started have not reached the last place, which
+    // moves to the calling thread
+    if (started < threads) {
+        atomic_store(&fleet->start.parties, started);
+        atomic_store(&fleet->done.parties, started);
+    }
+    fleet->threads = started;
+}
+
+// Advances every drone by one time step under its force. The drones are split
+// in one contiguous range per worker and the call returns once all of them
+// have been stepped.
+void fleet_step(struct fleet *fleet, const struct world_snapshot *world,
+                const struct drone_config *params) {
+    fleet->world  = world;
+    fleet->params = params;
+
+    int per_worker = (fleet->count + fleet->threads - 1) / fleet->threads;
+    for (int w = 0; w < fleet->threads; w++) {
+        int first = w * per_worker;
+        int end   = first + per_worker;
+        fleet->queues[w].end = end < fleet->count ? end : fleet->count;
+        atomic_store_explicit(&fleet->queues[w].next, first,
+                              memory_order_relaxed);
+    }
+
+    // The barriers order the inputs above before the tick and the stepped
+    // bodies before the return
+    barrier_wait(&fleet->start);
+    run_tick(fleet, 0);
+    barrier_wait(&fleet->done);
+}
+
+// Stops and joins the workers
+void fleet_destroy(struct fleet *fleet) {
+    fleet->stopping = true;
+    barrier_wait(&fleet->start);
+    for (int w = 1; w < fleet->threads; w++)
+        pthread_join(fleet->workers[w].thread, NULL);
+}
@@ -0,0 +1,107 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "config/config.h"
+#include "droneDataStructs.h"
+#include "grid/grid.h"
+#include "physics/physics.h"
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Maximum number of drones and of threads of a fleet. The fleet is not bound
+// to MAX_DRONES, so that larger fleets can be benchmarked.
+#define FLEET_MAX_DRONES 1024
+#define FLEET_MAX_THREADS 64
+// Drones claimed at once by a worker, four cache lines of bodies
+#define FLEET_CHUNK 8
+// Polls of the barrier before sleeping on it
+#define FLEET_SPIN 4000
+
+// Obstacles and targets seen by every drone of the fleet. It is modified only
+// between two ticks, while the workers wait on the barrier, so that during a
+// tick it is immutable and read without any lock.
+struct world_snapshot {
+    struct entity_store targets;
+    struct entity_store obstacles;
+    struct spatial_grid targets_grid;
+    struct spatial_grid obstacles_grid;
+    struct force_luts luts;
+    // Rasterized walls and obstacles, NULL to evaluate them
+    const struct potential_field *potential;
+    // Changes of the obstacles or of the parameters, to follow them with the
+    // static field
+    unsigned long obstacles_version;
+};
+
+// Barrier between the ticks. The threads spin for a while, since the next
+// tick usually comes soon, then sleep on a futex. The last thread to arrive
+// starts a new generation and wakes the sleepers, if any.
+struct fleet_barrier {
+    alignas(64) _Atomic int arrived;
+    _Atomic unsigned int generation;
+    _Atomic int sleepers;
+    _Atomic int parties;
+    int spin; // Polls before sleeping, none if the cores are oversubscribed
+};
+
+// Range of drones owned by a worker in the current tick. The owner and the
+// thieves claim chunks from the same counter, so a chunk is stepped once.
+struct fleet_queue {
+    alignas(64) _Atomic int next;
+    int end;
+};
+
+struct fleet;
+
+// Thread of the pool, worker 0 being the caller of fleet_step
+struct fleet_worker {
+    struct fleet *fleet;
+    int index;
+    pthread_t thread;
+};
+
+// Called by the worker that stepped a drone, e.g. to publish its state
+typedef void (*fleet_publish)(void *context, int id,
+                              const struct drone_body *body);
+
+// Drones stepped in parallel by a pool of threads. The calling thread is
+// worker 0, the other ones are created by fleet_init and run one tick each
+// time fleet_step releases the start barrier.
+struct fleet {
+    int count;
+    int threads;
+    alignas(64) struct drone_body bodies[FLEET_MAX_DRONES];
+    struct force forces[FLEET_MAX_DRONES];
+
+    // Inputs of the current tick, set before releasing the workers
+    const struct world_snapshot *world;
+    const struct drone_config *params;
+    fleet_publish publish;
+    void *context;
+    bool stopping;
+
+    struct fleet_queue queues[FLEET_MAX_THREADS];
+    struct fleet_barrier start;
+    struct fleet_barrier done;
+    struct fleet_worker workers[FLEET_MAX_THREADS];
+};
+
+void world_init(struct world_snapshot *world,
+                const struct drone_config *params);
+void world_set_targets(struct world_snapshot *world, const struct pos *items,
+                       int count, const struct drone_config *params);
+void world_set_obstacles(struct world_snapshot *world, const struct pos *items,
+                         int count, const struct drone_config *params);
+bool world_remove_target(struct world_snapshot *world, int index,
+                         struct pos position);
+void world_reindex(struct world_snapshot *world,
+                   const struct drone_config *params);
+
+void fleet_init(struct fleet *fleet, int count, int threads);
+void fleet_step(struct fleet *fleet, const struct world_snapshot *world,
+                const struct drone_config *params);
+void fleet_destroy(struct fleet *fleet);
+
+#endif // !FLEET_H
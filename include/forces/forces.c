@@ -0,0 +1,163 @@
+#include "forces/forces.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FORCES_X86
+#endif
+
+void store_load(struct entity_store *store, const struct pos *items,
+                int count) {
+    for (int i = 0; i < count; i++) {
+        store->x[i] = items[i].x;
+        store->y[i] = items[i].y;
+    }
+    store->count = count;
+}
+
+// Removes an entity keeping the order of the others, like remove_target
+void store_remove(struct entity_store *store, int index) {
+    int moved = store->count - index - 1;
+    memmove(&store->x[index], &store->x[index + 1], moved * sizeof(float));
+    memmove(&store->y[index], &store->y[index + 1], moved * sizeof(float));
+    store->count--;
+}
+
+// Contribution of one entity. The direction is the normalized distance
+// vector, no trigonometric function is involved.
+static void field_force_scalar(const float *x, const float *y, int begin,
+                               int end, float px, float py, float min_distance,
+                               float area_of_effect, float *sum_x,
+                               float *sum_y) {
+    float inv_area = 1.0f / area_of_effect;
+    for (int i = begin; i < end; i++) {
+        float dx       = x[i] - px;
+        float dy       = y[i] - py;
+        float distance = sqrtf(dx * dx + dy * dy);
+        if (distance < area_of_effect && distance > min_distance) {
+            float inv_d  = 1.0f / distance;
+            float weight = (inv_d - inv_area) * inv_d * inv_d * inv_d;
+            *sum_x += weight * dx;
+            *sum_y += weight * dy;
+        }
+    }
+}
+
+#ifdef FORCES_X86
+// Same computation as field_force_scalar on 8 entities at a time. Entities out
+// of range are masked out of the sums.
+__attribute__((target("avx2,fma"))) static int
+field_force_avx2(const float *x, const float *y, int count, float px, float py,
+                 float min_distance, float area_of_effect, float *sum_x,
+                 float *sum_y) {
+    __m256 vpx       = _mm256_set1_ps(px);
+    __m256 vpy       = _mm256_set1_ps(py);
+    __m256 vmin      = _mm256_set1_ps(min_distance);
+    __m256 varea     = _mm256_set1_ps(area_of_effect);
+    __m256 vinv_area = _mm256_set1_ps(1.0f / area_of_effect);
+    __m256 one       = _mm256_set1_ps(1.0f);
+    __m256 acc_x     = _mm256_setzero_ps();
+    __m256 acc_y     = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx       = _mm256_sub_ps(_mm256_loadu_ps(&x[i]), vpx);
+        __m256 dy       = _mm256_sub_ps(_mm256_loadu_ps(&y[i]), vpy);
+        __m256 distance =
+            _mm256_sqrt_ps(_mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy)));
+        __m256 in_range =
+            _mm256_and_ps(_mm256_cmp_ps(distance, varea, _CMP_LT_OQ),
+                          _mm256_cmp_ps(distance, vmin, _CMP_GT_OQ));
+        __m256 inv_d    = _mm256_div_ps(one, distance);
+        __m256 inv_d3   = _mm256_mul_ps(_mm256_mul_ps(inv_d, inv_d), inv_d);
+        __m256 weight   = _mm256_and_ps(
+            in_range, _mm256_mul_ps(_mm256_sub_ps(inv_d, vinv_area), inv_d3));
+        acc_x           = _mm256_fmadd_ps(weight, dx, acc_x);
+        acc_y           = _mm256_fmadd_ps(weight, dy, acc_y);
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc_x);
+    for (int k = 0; k < 8; k++)
+        *sum_x += lanes[k];
+    _mm256_storeu_ps(lanes, acc_y);
+    for (int k = 0; k < 8; k++)
+        *sum_y += lanes[k];
+
+    // The compiler only adds it when optimizing. Without it the SSE code run
+    // afterwards, libm included, pays for the dirty upper halves.
+    _mm256_zeroupper();
+    return i;
+}
+
+// SSE version, 4 entities at a time
+static int field_force_sse(const float *x, const float *y, int count,
+                           float px, float py, float min_distance,
+                           float area_of_effect, float *sum_x, float *sum_y) {
+    __m128 vpx       = _mm_set1_ps(px);
+    __m128 vpy       = _mm_set1_ps(py);
+    __m128 vmin      = _mm_set1_ps(min_distance);
+    __m128 varea     = _mm_set1_ps(area_of_effect);
+    __m128 vinv_area = _mm_set1_ps(1.0f / area_of_effect);
+    __m128 one       = _mm_set1_ps(1.0f);
+    __m128 acc_x     = _mm_setzero_ps();
+    __m128 acc_y     = _mm_setzero_ps();
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx       = _mm_sub_ps(_mm_loadu_ps(&x[i]), vpx);
+        __m128 dy       = _mm_sub_ps(_mm_loadu_ps(&y[i]), vpy);
+        __m128 distance =
+            _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 in_range = _mm_and_ps(_mm_cmplt_ps(distance, varea),
+                                     _mm_cmpgt_ps(distance, vmin));
+        __m128 inv_d    = _mm_div_ps(one, distance);
+        __m128 inv_d3   = _mm_mul_ps(_mm_mul_ps(inv_d, inv_d), inv_d);
+        __m128 weight   = _mm_and_ps(
+            in_range, _mm_mul_ps(_mm_sub_ps(inv_d, vinv_area), inv_d3));
+        acc_x           = _mm_add_ps(acc_x, _mm_mul_ps(weight, dx));
+        acc_y           = _mm_add_ps(acc_y, _mm_mul_ps(weight, dy));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc_x);
+    *sum_x += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_ps(lanes, acc_y);
+    *sum_y += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return i;
+}
+
+// The widest instruction set of the CPU, detected once before main so that the
+// threads of the fleet only ever read it
+static bool use_avx2;
+
+__attribute__((constructor)) static void field_force_detect(void) {
+    // Needed by __builtin_cpu_supports when run before the libgcc constructor
+    __builtin_cpu_init();
+    use_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+struct force field_force(const float *x, const float *y, int count, float px,
+                         float py, float min_distance, float area_of_effect) {
+    float sum_x = 0, sum_y = 0;
+    int done    = 0;
+
+#ifdef FORCES_X86
+    if (use_avx2)
+        done = field_force_avx2(x, y, count, px, py, min_distance,
+                                area_of_effect, &sum_x, &sum_y);
+    else
+        done = field_force_sse(x, y, count, px, py, min_distance,
+                               area_of_effect, &sum_x, &sum_y);
+#endif
+
+    // Remaining entities, or all of them without SIMD support
+    field_force_scalar(x, y, done, count, px, py, min_distance, area_of_effect,
+                       &sum_x, &sum_y);
+
+    struct force result = {sum_x, sum_y};
+    return result;
+}
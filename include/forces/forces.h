@@ -0,0 +1,30 @@
+#ifndef FORCES_H
+#define FORCES_H
+
+#include "constants.h"
+#include "droneDataStructs.h"
+#include <stdalign.h>
+
+// Capacity of an entity store, rounded up to a whole number of AVX registers
+#define STORE_CAPACITY ((MAX_ENTITIES + 7) & ~7)
+
+// Positions of a set of targets or obstacles stored as structure of arrays,
+// so that the force kernel loads 4 or 8 coordinates with a single instruction
+struct entity_store {
+    alignas(32) float x[STORE_CAPACITY];
+    alignas(32) float y[STORE_CAPACITY];
+    int count;
+};
+
+void store_load(struct entity_store *store, const struct pos *items,
+                int count);
+void store_remove(struct entity_store *store, int index);
+
+// Sum over the entities at a distance in (min_distance, area_of_effect) from
+// (px, py) of (1/d - 1/area_of_effect) / d^2 times the unit vector pointing to
+// the entity. Multiplied by the function scale and the drone speed it gives
+// the force of the Latombe / Kathib's model, see compute_repulsive_force.
+struct force field_force(const float *x, const float *y, int count, float px,
+                         float py, float min_distance, float area_of_effect);
+
+#endif // !FORCES_H
@@ -0,0 +1,189 @@
+#include "grid/grid.h"
+#include <math.h>
+#include <string.h>
+
+// Coordinate given to removed entities: far enough to be out of any effect
+// range, small enough to keep the kernel arithmetic finite
+#define GRID_TOMBSTONE 1e9f
+
+static int grid_clamp(int value, int max) {
+    return value < 0 ? 0 : value > max ? max : value;
+}
+
+static int grid_cell(const struct spatial_grid *grid, float x, float y) {
+    int col = grid_clamp((int)(x / grid->cell_size), grid->cols - 1);
+    int row = grid_clamp((int)(y / grid->cell_size), grid->rows - 1);
+    return row * grid->cols + col;
+}
+
+// Sorts the entities of the store by cell with a counting sort, O(N + cells).
+// The cells are as large as the effect radius, so that a query only visits
+// the neighbouring cells.
+void grid_build(struct spatial_grid *grid, const struct entity_store *store,
+                float radius) {
+    float min_size = (float)SIMULATION_WIDTH / GRID_MAX_DIM;
+    if ((float)SIMULATION_HEIGHT / GRID_MAX_DIM > min_size)
+        min_size = (float)SIMULATION_HEIGHT / GRID_MAX_DIM;
+    grid->cell_size = radius > min_size ? radius : min_size;
+    grid->cols      = (int)(SIMULATION_WIDTH / grid->cell_size) + 1;
+    grid->rows      = (int)(SIMULATION_HEIGHT / grid->cell_size) + 1;
+    if (grid->cols > GRID_MAX_DIM)
+        grid->cols = GRID_MAX_DIM;
+    if (grid->rows > GRID_MAX_DIM)
+        grid->rows = GRID_MAX_DIM;
+    grid->count = store->count;
+
+    int cells = grid->cols * grid->rows;
+    int cell_of[STORE_CAPACITY];
+    memset(grid->cell_start, 0, (cells + 1) * sizeof(int));
+
+    // Count the entities of each cell, then turn the counts into offsets
+    for (int i = 0; i < store->count; i++) {
+        cell_of[i] = grid_cell(grid, store->x[i], store->y[i]);
+        grid->cell_start[cell_of[i] + 1]++;
+    }
+    for (int c = 0; c < cells; c++)
+        grid->cell_start[c + 1] += grid->cell_start[c];
+
+    int fill[GRID_MAX_DIM * GRID_MAX_DIM];
+    memcpy(fill, grid->cell_start, cells * sizeof(int));
+    for (int i = 0; i < store->count; i++) {
+        int slot         = fill[cell_of[i]]++;
+        grid->x[slot]    = store->x[i];
+        grid->y[slot]    = store->y[i];
+        grid->slot_of[i] = slot;
+    }
+}
+
+// Removes the entity at index in the store order, following store_remove.
+// Its slot is left as a tombstone until the next build, so the cells do not
+// have to be compacted.
+void grid_remove(struct spatial_grid *grid, int index) {
+    int slot      = grid->slot_of[index];
+    grid->x[slot] = GRID_TOMBSTONE;
+    grid->y[slot] = GRID_TOMBSTONE;
+
+    memmove(&grid->slot_of[index], &grid->slot_of[index + 1],
+            (grid->count - index - 1) * sizeof(int));
+    grid->count--;
+}
+
+// Same result as field_force on the whole store, visiting only the cells
+// closer than area_of_effect to (px, py). The weights are read from the
+// profile if one is given, see lut_field_force.
+struct force grid_field_force(const struct spatial_grid *grid, float px,
+                              float py, float min_distance,
+                              float area_of_effect,
+                              const struct radial_lut *lut) {
+    int col_min = grid_clamp((int)((px - area_of_effect) / grid->cell_size),
+                             grid->cols - 1);
+    int col_max = grid_clamp((int)((px + area_of_effect) / grid->cell_size),
+                             grid->cols - 1);
+    int row_min = grid_clamp((int)((py - area_of_effect) / grid->cell_size),
+                             grid->rows - 1);
+    int row_max = grid_clamp((int)((py + area_of_effect) / grid->cell_size),
+                             grid->rows - 1);
+
+    struct force total = {0, 0};
+    for (int row = row_min; row <= row_max; row++) {
+        int begin = grid->cell_start[row * grid->cols + col_min];
+        int end   = grid->cell_start[row * grid->cols + col_max + 1];
+        if (begin == end)
+            continue;
+
+        struct force part;
+        if (lut)
+            part = lut_field_force(lut, &grid->x[begin], &grid->y[begin],
+                                   end - begin, px, py, min_distance);
+        else
+            part = field_force(&grid->x[begin], &grid->y[begin], end - begin,
+                               px, py, min_distance, area_of_effect);
+        total.x_component += part.x_component;
+        total.y_component += part.y_component;
+    }
+    return total;
+}
+
+// Earliest time of impact of the segment from + t * delta, t in [0, 1], with
+// the discs of the given radius centred on the entities, visiting only the
+// cells around the segment. Returns t, or a value above 1 if no disc is hit,
+// and sets normal to the unit normal of the disc at the contact. A segment
+// moving away from a disc is not stopped by it, so that a drone starting
+// inside one, or left on its surface by the previous contact, can get out.
+float grid_sweep_discs(const struct spatial_grid *grid, struct pos from,
+                       struct pos delta, float radius, struct pos *normal) {
+    float min_x = fminf(from.x, from.x + delta.x) - radius;
+    float max_x = fmaxf(from.x, from.x + delta.x) + radius;
+    float min_y = fminf(from.y, from.y + delta.y) - radius;
+    float max_y = fmaxf(from.y, from.y + delta.y) + radius;
+    int col_min = grid_clamp((int)(min_x / grid->cell_size), grid->cols - 1);
+    int col_max = grid_clamp((int)(max_x / grid->cell_size), grid->cols - 1);
+    int row_min = grid_clamp((int)(min_y / grid->cell_size), grid->rows - 1);
+    int row_max = grid_clamp((int)(max_y / grid->cell_size), grid->rows - 1);
+
+    float a    = delta.x * delta.x + delta.y * delta.y;
+    float best = 2;
+    if (a == 0)
+        return best;
+
+    for (int row = row_min; row <= row_max; row++) {
+        int begin = grid->cell_start[row * grid->cols + col_min];
+        int end   = grid->cell_start[row * grid->cols + col_max + 1];
+        for (int i = begin; i < end; i++) {
+            // |from - centre + t * delta|^2 = radius^2, a t^2 + 2 b t + c = 0
+            float fx = from.x - grid->x[i];
+            float fy = from.y - grid->y[i];
+            float b  = fx * delta.x + fy * delta.y;
+            float c  = fx * fx + fy * fy - radius * radius;
+            if (b >= 0)
+                continue;
+
+            float t = 0;
+            if (c > 0) {
+                float discriminant = b * b - a * c;
+                if (discriminant < 0)
+                    continue;
+                t = (-b - sqrtf(discriminant)) / a;
+            }
+            if (t >= best || t > 1)
+                continue;
+
+            float nx   = fx + t * delta.x;
+            float ny   = fy + t * delta.y;
+            float norm = sqrtf(nx * nx + ny * ny);
+            if (norm == 0)
+                continue;
+            best      = t;
+            normal->x = nx / norm;
+            normal->y = ny / norm;
+        }
+    }
+    return best;
+}
+
+// Distance from (px, py) to the nearest entity, visiting only the cells
+// closer than max_distance. Returns max_distance if none is closer.
+float grid_nearest(const struct spatial_grid *grid, float px, float py,
+                   float max_distance) {
+    int col_min = grid_clamp((int)((px - max_distance) / grid->cell_size),
+                             grid->cols - 1);
+    int col_max = grid_clamp((int)((px + max_distance) / grid->cell_size),
+                             grid->cols - 1);
+    int row_min = grid_clamp((int)((py - max_distance) / grid->cell_size),
+                             grid->rows - 1);
+    int row_max = grid_clamp((int)((py + max_distance) / grid->cell_size),
+                             grid->rows - 1);
+
+    float nearest = max_distance * max_distance;
+    for (int row = row_min; row <= row_max; row++) {
+        int begin = grid->cell_start[row * grid->cols + col_min];
+        int end   = grid->cell_start[row * grid->cols + col_max + 1];
+        for (int i = begin; i < end; i++) {
+            float dx = grid->x[i] - px;
+            float dy = grid->y[i] - py;
+            if (dx * dx + dy * dy < nearest)
+                nearest = dx * dx + dy * dy;
+        }
+    }
+    return sqrtf(nearest);
+}
@@ -0,0 +1,42 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "forces/forces.h"
+#include "lut/lut.h"
+#include <stdalign.h>
+
+// Maximum number of cells per side of the grid, it bounds the memory used
+// when the effect radius is small
+#define GRID_MAX_DIM 64
+
+// Uniform grid over the simulation area. Entities are sorted by cell in row
+// major order, so the cells of a row touched by a query are contiguous in x
+// and y and are handed to the force kernel with a single call.
+struct spatial_grid {
+    float cell_size;
+    int cols;
+    int rows;
+    // Entities of cell c are stored in [cell_start[c], cell_start[c + 1])
+    int cell_start[GRID_MAX_DIM * GRID_MAX_DIM + 1];
+    alignas(32) float x[STORE_CAPACITY];
+    alignas(32) float y[STORE_CAPACITY];
+    // Slot in x and y of each entity, in the order of the entity store
+    int slot_of[STORE_CAPACITY];
+    int count;
+};
+
+void grid_build(struct spatial_grid *grid, const struct entity_store *store,
+                float radius);
+void grid_remove(struct spatial_grid *grid, int index);
+struct force grid_field_force(const struct spatial_grid *grid, float px,
+                              float py, float min_distance,
+                              float area_of_effect,
+                              const struct radial_lut *lut);
+float grid_nearest(const struct spatial_grid *grid, float px, float py,
+                   float max_distance);
+float grid_sweep_discs(const struct spatial_grid *grid, struct pos from,
+                       struct pos delta, float radius, struct pos *normal);
+
+#endif // !GRID_H
@@ -0,0 +1,214 @@
+#include "logger/logger.h"
+#include "constants.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <time.h>
+#include <unistd.h>
+
+// Number of messages the ring can hold, must be a power of two. When the
+// ring is full new messages are dropped and counted instead of blocking.
+#define LOG_RING_SLOTS 256
+// Maximum length of a message, longer ones are truncated
+#define LOG_LINE_LEN 256
+// Period of the background flusher
+#define LOG_FLUSH_PERIOD_MS 100
+
+// The logger must not use the wrappers: they log their own errors
+struct log_entry {
+    _Atomic uint32_t sequence;
+    enum log_level level;
+    char type[8];
+    struct timespec timestamp;
+    char text[LOG_LINE_LEN];
+};
+
+// Per process bounded MPSC ring. Producers claim a slot with a CAS on head
+// and publish it through its sequence number, the flusher consumes from tail.
+static struct {
+    struct log_entry entries[LOG_RING_SLOTS];
+    _Atomic uint32_t head;
+    uint32_t tail;
+    _Atomic uint32_t dropped;
+    _Atomic int running;
+    enum log_level level;
+    pid_t pid;
+    pthread_mutex_t flush_lock;
+    pthread_mutex_t start_lock;
+} logger = {.flush_lock = PTHREAD_MUTEX_INITIALIZER,
+            .start_lock = PTHREAD_MUTEX_INITIALIZER};
+
+enum log_level log_level_from_name(const char *name) {
+    if (strcmp(name, "DEBUG") == 0)
+        return LOG_LEVEL_DEBUG;
+    if (strcmp(name, "WARN") == 0)
+        return LOG_LEVEL_WARN;
+    if (strcmp(name, "ERROR") == 0)
+        return LOG_LEVEL_ERROR;
+    return LOG_LEVEL_INFO;
+}
+
+static void log_reset(void) {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; i++)
+        atomic_store_explicit(&logger.entries[i].sequence, i,
+                              memory_order_relaxed);
+    atomic_store_explicit(&logger.head, 0, memory_order_relaxed);
+    logger.tail = 0;
+    atomic_store_explicit(&logger.dropped, 0, memory_order_relaxed);
+
+    const char *level = getenv("LOG_LEVEL");
+    logger.level = level ? log_level_from_name(level) : LOG_DEFAULT_LEVEL;
+    logger.pid   = getpid();
+}
+
+// A forked child has no flusher thread and must not write the messages
+// still queued by its parent, so it starts from an empty logger
+static void log_after_fork(void) {
+    pthread_mutex_init(&logger.flush_lock, NULL);
+    pthread_mutex_init(&logger.start_lock, NULL);
+    atomic_store_explicit(&logger.running, 0, memory_order_relaxed);
+}
+
+static void *log_flusher(void *arg) {
+    (void)arg;
+    struct timespec period = {0, LOG_FLUSH_PERIOD_MS * 1000000L};
+    while (1) {
+        nanosleep(&period, NULL);
+        log_flush();
+    }
+    return NULL;
+}
+
+// Starts the flusher of the calling process on its first message
+static void log_start(void) {
+    pthread_mutex_lock(&logger.start_lock);
+    if (!atomic_load_explicit(&logger.running, memory_order_acquire)) {
+        log_reset();
+
+        // The flusher blocks every signal, so that the watchdog pings and
+        // the ncurses signals keep being delivered to the main thread
+        sigset_t all, old;
+        sigfillset(&all);
+        pthread_sigmask(SIG_SETMASK, &all, &old);
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, log_flusher, NULL) == 0)
+            pthread_detach(thread);
+        pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+        static bool registered = false;
+        if (!registered) {
+            atexit(log_flush);
+            pthread_atfork(NULL, NULL, log_after_fork);
+            registered = true;
+        }
+        atomic_store_explicit(&logger.running, 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&logger.start_lock);
+}
+
+// Queues a message without any syscall nor lock. Errors are flushed right
+// away since the process is usually about to exit.
+void log_write(enum log_level level, const char *type, const char *message) {
+    if (!atomic_load_explicit(&logger.running, memory_order_acquire))
+        log_start();
+    if (level < logger.level)
+        return;
+
+    uint32_t pos = atomic_load_explicit(&logger.head, memory_order_relaxed);
+    struct log_entry *entry;
+    while (1) {
+        entry        = &logger.entries[pos & (LOG_RING_SLOTS - 1)];
+        uint32_t seq = atomic_load_explicit(&entry->sequence,
+                                            memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &logger.head, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The ring is full
+            atomic_fetch_add_explicit(&logger.dropped, 1,
+                                      memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&logger.head, memory_order_relaxed);
+        }
+    }
+
+    entry->level = level;
+    snprintf(entry->type, sizeof(entry->type), "%s", type);
+    clock_gettime(CLOCK_MONOTONIC, &entry->timestamp);
+    snprintf(entry->text, sizeof(entry->text), "%s", message);
+    atomic_store_explicit(&entry->sequence, pos + 1, memory_order_release);
+
+    if (level >= LOG_LEVEL_ERROR)
+        log_flush();
+}
+
+// Appends buffer to the log file with a single write, holding the file lock
+// only for this batch
+static void log_write_batch(const char *buffer, size_t length) {
+    if (length == 0)
+        return;
+
+    int fd = open(LOGFILE_PATH, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC,
+                  0666);
+    if (fd < 0)
+        return;
+    flock(fd, LOCK_EX);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t ret = write(fd, buffer + done, length - done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            break;
+        done += ret;
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+// Formats every queued message and writes them in one batch
+void log_flush(void) {
+    static char buffer[LOG_RING_SLOTS * (LOG_LINE_LEN + 64)];
+
+    pthread_mutex_lock(&logger.flush_lock);
+    size_t length = 0;
+    while (1) {
+        struct log_entry *entry =
+            &logger.entries[logger.tail & (LOG_RING_SLOTS - 1)];
+        uint32_t seq =
+            atomic_load_explicit(&entry->sequence, memory_order_acquire);
+        if ((int32_t)(seq - (logger.tail + 1)) < 0)
+            break;
+
+        length += snprintf(buffer + length, sizeof(buffer) - length,
+                           "[%ld.%06ld] [%d] [%s] - %s\n",
+                           (long)entry->timestamp.tv_sec,
+                           entry->timestamp.tv_nsec / 1000, logger.pid,
+                           entry->type, entry->text);
+        atomic_store_explicit(&entry->sequence, logger.tail + LOG_RING_SLOTS,
+                              memory_order_release);
+        logger.tail++;
+    }
+
+    uint32_t dropped =
+        atomic_exchange_explicit(&logger.dropped, 0, memory_order_relaxed);
+    if (dropped > 0)
+        length += snprintf(buffer + length, sizeof(buffer) - length,
+                           "[%d] [WARN] - %u log messages dropped\n",
+                           logger.pid, dropped);
+
+    log_write_batch(buffer, length);
+    pthread_mutex_unlock(&logger.flush_lock);
+}
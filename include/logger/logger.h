@@ -0,0 +1,36 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// Severity of a log message, messages below the active level are discarded
+enum log_level {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR
+};
+
+// Messages logged through the LOG_* macros below this level are removed at
+// compile time, e.g. -DLOG_COMPILE_LEVEL=LOG_LEVEL_INFO
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Level used at runtime when the LOG_LEVEL environment variable is not set
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
+
+void log_write(enum log_level level, const char *type, const char *message);
+void log_flush(void);
+enum log_level log_level_from_name(const char *name);
+
+#define LOG_AT(level, type, message)                                           \
+    do {                                                                       \
+        if ((level) >= LOG_COMPILE_LEVEL)                                      \
+            log_write((level), (type), (message));                             \
+    } while (0)
+
+#define LOG_DEBUG(message) LOG_AT(LOG_LEVEL_DEBUG, "DEBUG", message)
+#define LOG_INFO(message) LOG_AT(LOG_LEVEL_INFO, "INFO", message)
+#define LOG_WARN(message) LOG_AT(LOG_LEVEL_WARN, "WARN", message)
+#define LOG_ERROR(message) LOG_AT(LOG_LEVEL_ERROR, "ERROR", message)
+
+#endif // !LOGGER_H
@@ -0,0 +1,91 @@
+#include "lut/lut.h"
+#include <math.h>
+
+// Tabulates (1/d - 1/radius) / d^3 against d^2, the weight of the distance
+// vector in field_force. The value at 0 is infinite and replaced by the next
+// one; closer entities are excluded by min_distance or the forces are capped.
+static void build_field(struct radial_lut *lut, float radius) {
+    double extent = (double)radius * radius;
+    double step   = extent / LUT_SIZE;
+    lut->extent   = extent;
+    lut->inv_step = 1 / step;
+    for (int i = 1; i <= LUT_SIZE; i++) {
+        double d       = sqrt(i * step);
+        lut->values[i] = (1 / d - 1 / (double)radius) / (d * d * d);
+    }
+    lut->values[0] = lut->values[1];
+}
+
+// Tabulates compute_repulsive_force without the speed against the distance
+static void build_walls(struct radial_lut *lut, float function_scale,
+                        float area_of_effect) {
+    double step   = (double)area_of_effect / LUT_SIZE;
+    lut->extent   = area_of_effect;
+    lut->inv_step = 1 / step;
+    for (int i = 1; i <= LUT_SIZE; i++) {
+        double d       = i * step;
+        lut->values[i] = function_scale * (1 / d - 1 / (double)area_of_effect) /
+                         (d * d);
+    }
+    lut->values[0] = lut->values[1];
+}
+
+void luts_init(struct force_luts *luts) {
+    luts->enabled = false;
+    luts->built   = false;
+}
+
+// Follows a new configuration. The profiles are built again only if a
+// parameter they depend on changed, and not at all while they are disabled.
+void luts_update(struct force_luts *luts, const struct drone_config *params) {
+    luts->enabled = params->field_cache;
+    if (!luts->enabled)
+        return;
+    if (luts->built && luts->function_scale == params->function_scale &&
+        luts->area_of_effect == params->area_of_effect &&
+        luts->obst_of_effect == params->obst_of_effect &&
+        luts->targ_of_effect == params->targ_of_effect)
+        return;
+
+    luts->function_scale = params->function_scale;
+    luts->area_of_effect = params->area_of_effect;
+    luts->obst_of_effect = params->obst_of_effect;
+    luts->targ_of_effect = params->targ_of_effect;
+    build_field(&luts->obstacles, params->obst_of_effect);
+    build_field(&luts->targets, params->targ_of_effect);
+    build_walls(&luts->walls, params->function_scale, params->area_of_effect);
+    luts->built = true;
+}
+
+// Value of the profile at the given index, 0 beyond its extent
+float lut_sample(const struct radial_lut *lut, float at) {
+    float position = at * lut->inv_step;
+    if (position >= LUT_SIZE)
+        return 0;
+    if (position < 0)
+        position = 0;
+    int i      = (int)position;
+    float frac = position - i;
+    return lut->values[i] + frac * (lut->values[i + 1] - lut->values[i]);
+}
+
+// Same sum as field_force, the weights being read from the profile indexed by
+// the squared distance
+struct force lut_field_force(const struct radial_lut *lut, const float *x,
+                             const float *y, int count, float px, float py,
+                             float min_distance) {
+    float min_squared = min_distance * min_distance;
+    float sum_x = 0, sum_y = 0;
+    for (int i = 0; i < count; i++) {
+        float dx      = x[i] - px;
+        float dy      = y[i] - py;
+        float squared = dx * dx + dy * dy;
+        if (squared > min_squared) {
+            float weight = lut_sample(lut, squared);
+            sum_x += weight * dx;
+            sum_y += weight * dy;
+        }
+    }
+    struct force result = {sum_x, sum_y};
+    return result;
+}
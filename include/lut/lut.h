@@ -0,0 +1,43 @@
+#ifndef LUT_H
+#define LUT_H
+
+#include "config/config.h"
+#include "droneDataStructs.h"
+#include <stdbool.h>
+
+// Entries of a radial profile, the last one being the value at the radius
+#define LUT_SIZE 4096
+
+// Radial profile of a field tabulated on [0, extent] and sampled by linear
+// interpolation. The profiles of the obstacles and targets are indexed by the
+// squared distance, so that the kernel needs no square root, the profile of
+// the walls by the distance.
+struct radial_lut {
+    float extent;
+    float inv_step; // Entries per unit of the index
+    float values[LUT_SIZE + 1];
+};
+
+// Profiles of the Latombe / Kathib's model for the parameters they were built
+// with. They are built again only when function_scale or an effect radius
+// changes, and used by physics_step only if field_cache is set in the config.
+struct force_luts {
+    bool enabled;
+    bool built;
+    float function_scale;
+    float area_of_effect;
+    float obst_of_effect;
+    float targ_of_effect;
+    struct radial_lut obstacles;
+    struct radial_lut targets;
+    struct radial_lut walls; // function_scale included
+};
+
+void luts_init(struct force_luts *luts);
+void luts_update(struct force_luts *luts, const struct drone_config *params);
+float lut_sample(const struct radial_lut *lut, float at);
+struct force lut_field_force(const struct radial_lut *lut, const float *x,
+                             const float *y, int count, float px, float py,
+                             float min_distance);
+
+#endif // !LUT_H
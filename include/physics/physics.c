@@ -0,0 +1,477 @@
+#include "physics/physics.h"
+#include "constants.h"
+#include <math.h>
+#include <stdbool.h>
+
+// Computes the repulsive force exerted by a border based on the given
+// parameters. The formula used is detailed in the documentation. The parameters
+// can be adjusted in the configuration file.
+float compute_repulsive_force(float distance, float function_scale,
+                              float area_of_effect, float vel_x, float vel_y) {
+    // Calculates the repulsive force based on distance, velocity, and
+    // configured scaling.
+    return function_scale * ((1 / distance) - (1 / area_of_effect)) *
+           (1 / (distance * distance)) * sqrt(pow(vel_x, 2) + pow(vel_y, 2));
+}
+
+// Places the drone still at (x, y)
+void physics_init(struct drone_body *body, float x, float y) {
+    body->position.x = body->prev.x = body->prev2.x = x;
+    body->position.y = body->prev.y = body->prev2.y = y;
+    body->velocity.x_component = body->velocity.y_component = 0;
+}
+
+// Earliest time of impact of the segment from + t * delta, t in [0, 1], with
+// the walls inset by WALL_MARGIN. Returns t, or a value above 1 if no wall is
+// crossed, and sets normal to the inward normal of the wall hit. A segment
+// starting beyond a wall is stopped at once if it moves further out.
+static float sweep_walls(struct pos from, struct pos delta,
+                         struct pos *normal) {
+    const float start[2] = {from.x, from.y};
+    const float move[2]  = {delta.x, delta.y};
+    const float low[2]   = {WALL_MARGIN, WALL_MARGIN};
+    const float high[2]  = {SIMULATION_WIDTH - WALL_MARGIN,
+                            SIMULATION_HEIGHT - WALL_MARGIN};
+
+    float best = 2;
+    for (int axis = 0; axis < 2; axis++) {
+        float t, side;
+        if (move[axis] < 0 && start[axis] + move[axis] < low[axis]) {
+            t    = (low[axis] - start[axis]) / move[axis];
+            side = 1;
+        } else if (move[axis] > 0 && start[axis] + move[axis] > high[axis]) {
+            t    = (high[axis] - start[axis]) / move[axis];
+            side = -1;
+        } else {
+            continue;
+        }
+        if (t < 0)
+            t = 0;
+        if (t < best) {
+            best      = t;
+            normal->x = axis == 0 ? side : 0;
+            normal->y = axis == 1 ? side : 0;
+        }
+    }
+    return best;
+}
+
+// Reverses the component of v along the unit normal, scaled by the
+// restitution, if v points into the surface
+static void reflect(struct pos *v, struct pos normal) {
+    float into = v->x * normal.x + v->y * normal.y;
+    if (into >= 0)
+        return;
+    v->x -= (1 + COLLISION_RESTITUTION) * into * normal.x;
+    v->y -= (1 + COLLISION_RESTITUTION) * into * normal.y;
+}
+
+// Moves the drone along the segment from its previous position to the new
+// one, stopping at the first wall or obstacle disc crossed. The rest of the
+// segment is reflected at the contact and followed again, up to
+// MAX_COLLISIONS impacts. The displacement of a whole step, which gives the
+// velocity, is reflected at every impact. Returns true if there was one, the
+// new position being left untouched otherwise.
+static bool resolve_collisions(struct pos from, struct pos *to,
+                               struct pos *step,
+                               const struct spatial_grid *obstacles) {
+    struct pos delta = {to->x - from.x, to->y - from.y};
+    bool collided    = false;
+
+    for (int impacts = 0;; impacts++) {
+        struct pos normal = {0, 0}, disc_normal = {0, 0};
+        float t      = sweep_walls(from, delta, &normal);
+        float t_disc = grid_sweep_discs(obstacles, from, delta,
+                                        OBSTACLE_RADIUS, &disc_normal);
+        if (t_disc < t) {
+            t      = t_disc;
+            normal = disc_normal;
+        }
+        if (t > 1)
+            break;
+
+        // Move to the contact, then follow the rest of the step reflected
+        collided = true;
+        from.x += t * delta.x;
+        from.y += t * delta.y;
+        reflect(step, normal);
+        if (impacts == MAX_COLLISIONS - 1) {
+            delta = (struct pos){0, 0};
+            break;
+        }
+        reflect(&delta, normal);
+        delta.x *= 1 - t;
+        delta.y *= 1 - t;
+    }
+
+    if (collided) {
+        to->x = from.x + delta.x;
+        to->y = from.y + delta.y;
+    }
+    return collided;
+}
+
+// Sources of the forces acting on the drone during a step
+struct field {
+    const struct drone_config *params;
+    struct force user_force;
+    const struct spatial_grid *obstacles;
+    const struct spatial_grid *targets;
+    const struct force_luts *luts; // NULL to evaluate the exact profiles
+    // Walls and obstacles, NULL to evaluate them
+    const struct potential_field *potential;
+};
+
+// State advanced by the integrators over a substep
+struct motion {
+    struct pos position;
+    struct pos last; // One substep before, used by the Verlet schemes
+    struct velocity velocity;
+};
+
+// Repulsion of the simulation boundaries on the drone at position p moving at
+// velocity v. The function effect is applied only when within
+// 'area_of_effect' from a boundary.
+static struct force wall_force(const struct drone_config *params,
+                               struct pos p, struct velocity v) {
+    struct force walls;
+    float area_of_effect = params->area_of_effect;
+    float function_scale = params->function_scale;
+    if (p.x < area_of_effect) {
+        walls.x_component = compute_repulsive_force(
+            p.x, function_scale, area_of_effect, v.x_component, v.y_component);
+    } else if (p.x > SIMULATION_WIDTH - area_of_effect) {
+        walls.x_component = -compute_repulsive_force(
+            SIMULATION_WIDTH - p.x, function_scale, area_of_effect,
+            v.x_component, v.y_component);
+    } else {
+        walls.x_component =
+            0; // No force applied when sufficiently far from boundaries
+    }
+
+    // Compute repulsive force from top and bottom boundaries
+    if (p.y < area_of_effect) {
+        walls.y_component = compute_repulsive_force(
+            p.y, function_scale, area_of_effect, v.x_component, v.y_component);
+    } else if (p.y > SIMULATION_HEIGHT - area_of_effect) {
+        walls.y_component = -compute_repulsive_force(
+            SIMULATION_HEIGHT - p.y, function_scale, area_of_effect,
+            v.x_component, v.y_component);
+    } else {
+        walls.y_component = 0;
+    }
+
+    return walls;
+}
+
+// Total force on the drone at position p moving at velocity v: the user
+// force, the fields of the obstacles and targets indexed in the grids and the
+// repulsion of the walls
+static struct force total_force(const struct field *field, struct pos p,
+                                struct velocity v) {
+    const struct drone_config *params = field->params;
+    const struct force_luts *luts     = field->luts;
+    struct force walls;
+    struct force total_obstacles_forces;
+    struct force total_targets_forces;
+
+    // Both fields scale with the drone speed, which is the same for every
+    // obstacle and target, so it is applied once to the sums
+    float speed = sqrtf(v.x_component * v.x_component +
+                        v.y_component * v.y_component);
+
+    // The static fields of the walls and obstacles are read at once from
+    // the rasterized field, if there is one
+    struct potential_node statics;
+    if (field->potential)
+        statics = potential_sample(field->potential, p.x, p.y);
+
+    // Calculate repulsive forces from the obstacles within effect range
+    // and not too close, pointing away from them
+    struct force sum;
+    if (field->potential)
+        sum = statics.obstacles;
+    else
+        sum = grid_field_force(field->obstacles, p.x, p.y, 1,
+                               params->obst_of_effect,
+                               luts ? &luts->obstacles : NULL);
+    total_obstacles_forces.x_component = -10000 * speed * sum.x_component;
+    total_obstacles_forces.y_component = -10000 * speed * sum.y_component;
+
+    // Cap the force to prevent extreme values
+    total_obstacles_forces.x_component =
+        fmax(fmin(total_obstacles_forces.x_component, MAX_OBST_FORCES),
+             -MAX_OBST_FORCES);
+    total_obstacles_forces.y_component =
+        fmax(fmin(total_obstacles_forces.y_component, MAX_OBST_FORCES),
+             -MAX_OBST_FORCES);
+
+    // Compute attractive forces from the targets within effect range
+    sum = grid_field_force(field->targets, p.x, p.y, 0, params->targ_of_effect,
+                           luts ? &luts->targets : NULL);
+    total_targets_forces.x_component = 1000 * speed * sum.x_component;
+    total_targets_forces.y_component = 1000 * speed * sum.y_component;
+
+    // Cap forces to prevent extreme values
+    total_targets_forces.x_component =
+        fmax(fmin(total_targets_forces.x_component, MAX_TARG_FORCES),
+             -MAX_TARG_FORCES);
+    total_targets_forces.y_component =
+        fmax(fmin(total_targets_forces.y_component, MAX_TARG_FORCES),
+             -MAX_TARG_FORCES);
+
+    // Compute repulsive force from simulation boundaries. The profile of the
+    // table is 0 beyond area_of_effect, so at most one border of each axis
+    // contributes.
+    if (field->potential) {
+        walls.x_component = speed * statics.walls.x_component;
+        walls.y_component = speed * statics.walls.y_component;
+    } else if (luts) {
+        walls.x_component = speed * (lut_sample(&luts->walls, p.x) -
+                                     lut_sample(&luts->walls,
+                                                SIMULATION_WIDTH - p.x));
+        walls.y_component = speed * (lut_sample(&luts->walls, p.y) -
+                                     lut_sample(&luts->walls,
+                                                SIMULATION_HEIGHT - p.y));
+    } else {
+        walls = wall_force(params, p, v);
+    }
+
+    struct force total;
+    total.x_component = walls.x_component + field->user_force.x_component +
+                        total_obstacles_forces.x_component +
+                        total_targets_forces.x_component;
+    total.y_component = walls.y_component + field->user_force.y_component +
+                        total_obstacles_forces.y_component +
+                        total_targets_forces.y_component;
+    return total;
+}
+
+// Acceleration of the drone under a force, with the viscous drag
+static struct force acceleration(const struct drone_config *params,
+                                 struct force force, struct velocity v) {
+    float M = params->mass;
+    float K = params->viscous_coefficient;
+    return (struct force){(force.x_component - K * v.x_component) / M,
+                          (force.y_component - K * v.y_component) / M};
+}
+
+// An integrator advances the motion by h, given the force at the start of
+// the substep. The Verlet schemes take the velocity from the displacement.
+typedef void (*integrator_fn)(const struct field *field,
+                              struct motion *motion, struct force force,
+                              float h);
+
+// Verlet with the drag taken at the end of the substep, which keeps it stable
+// for a strong drag. The formula is detailed in the documentation.
+static void integrate_implicit_verlet(const struct field *field,
+                                      struct motion *motion,
+                                      struct force force, float h) {
+    float M = field->params->mass;                // Drone mass
+    float K = field->params->viscous_coefficient; // Drag coefficient
+
+    struct pos *x = &motion->position;
+    struct pos next;
+
+    next.x = (force.x_component - (M / (h * h)) * (motion->last.x - 2 * x->x) +
+              (K / h) * x->x) /
+             ((M / (h * h)) + K / h);
+    next.y = (force.y_component - (M / (h * h)) * (motion->last.y - 2 * x->y) +
+              (K / h) * x->y) /
+             ((M / (h * h)) + K / h);
+
+    motion->velocity.x_component = (next.x - x->x) / h;
+    motion->velocity.y_component = (next.y - x->y) / h;
+    *x = next;
+}
+
+// Stormer-Verlet, the drag being taken with the velocity of the last
+// substep
+static void integrate_verlet(const struct field *field,
+                             struct motion *motion, struct force force,
+                             float h) {
+    struct force a  = acceleration(field->params, force, motion->velocity);
+    struct pos *x   = &motion->position;
+    struct pos next = {2 * x->x - motion->last.x + h * h * a.x_component,
+                       2 * x->y - motion->last.y + h * h * a.y_component};
+
+    motion->velocity.x_component = (next.x - x->x) / h;
+    motion->velocity.y_component = (next.y - x->y) / h;
+    *x = next;
+}
+
+// Semi-implicit Euler: the velocity is updated first, then moves the drone
+static void integrate_euler(const struct field *field, struct motion *motion,
+                            struct force force, float h) {
+    struct force a = acceleration(field->params, force, motion->velocity);
+    motion->velocity.x_component += h * a.x_component;
+    motion->velocity.y_component += h * a.y_component;
+    motion->position.x += h * motion->velocity.x_component;
+    motion->position.y += h * motion->velocity.y_component;
+}
+
+// Classic Runge-Kutta of order 4, evaluating the forces at the start, twice
+// in the middle and at the end of the substep
+static void integrate_rk4(const struct field *field, struct motion *motion,
+                          struct force force, float h) {
+    const struct drone_config *params = field->params;
+
+    struct pos x0      = motion->position;
+    struct velocity v0 = motion->velocity;
+
+    struct velocity v1 = v0;
+    struct force a1    = acceleration(params, force, v1);
+
+    struct pos x2      = {x0.x + h / 2 * v1.x_component,
+                          x0.y + h / 2 * v1.y_component};
+    struct velocity v2 = {v0.x_component + h / 2 * a1.x_component,
+                          v0.y_component + h / 2 * a1.y_component};
+    struct force a2    = acceleration(params, total_force(field, x2, v2), v2);
+
+    struct pos x3      = {x0.x + h / 2 * v2.x_component,
+                          x0.y + h / 2 * v2.y_component};
+    struct velocity v3 = {v0.x_component + h / 2 * a2.x_component,
+                          v0.y_component + h / 2 * a2.y_component};
+    struct force a3    = acceleration(params, total_force(field, x3, v3), v3);
+
+    struct pos x4      = {x0.x + h * v3.x_component,
+                          x0.y + h * v3.y_component};
+    struct velocity v4 = {v0.x_component + h * a3.x_component,
+                          v0.y_component + h * a3.y_component};
+    struct force a4    = acceleration(params, total_force(field, x4, v4), v4);
+
+    motion->position.x = x0.x + h / 6 * (v1.x_component + 2 * v2.x_component +
+                                         2 * v3.x_component + v4.x_component);
+    motion->position.y = x0.y + h / 6 * (v1.y_component + 2 * v2.y_component +
+                                         2 * v3.y_component + v4.y_component);
+    motion->velocity.x_component =
+        v0.x_component + h / 6 * (a1.x_component + 2 * a2.x_component +
+                                  2 * a3.x_component + a4.x_component);
+    motion->velocity.y_component =
+        v0.y_component + h / 6 * (a1.y_component + 2 * a2.y_component +
+                                  2 * a3.y_component + a4.y_component);
+}
+
+// Indexed by enum integrator
+static const integrator_fn integrators[INTEGRATOR_COUNT] = {
+    integrate_implicit_verlet,
+    integrate_verlet,
+    integrate_euler,
+    integrate_rk4,
+};
+
+// Number of substeps of a step. The wall and obstacle forces grow as the
+// inverse cube of the distance, so the drone is not let move by more than
+// substep_tolerance times its clearance to them in one substep: far from
+// everything a step is a single substep, close to a surface it is split in
+// up to max_substeps.
+static int substep_count(const struct field *field,
+                         const struct motion *motion, float T) {
+    const struct drone_config *params = field->params;
+    int max_substeps                  = params->max_substeps;
+    if (params->substep_tolerance <= 0 || max_substeps <= 1)
+        return 1;
+
+    struct velocity v = motion->velocity;
+    float travel      = T * sqrtf(v.x_component * v.x_component +
+                                  v.y_component * v.y_component);
+    if (travel == 0)
+        return 1;
+
+    struct pos p    = motion->position;
+    float clearance = fminf(fminf(p.x, SIMULATION_WIDTH - p.x),
+                            fminf(p.y, SIMULATION_HEIGHT - p.y)) -
+                      WALL_MARGIN;
+    float nearest   = grid_nearest(field->obstacles, p.x, p.y,
+                                   clearance + OBSTACLE_RADIUS);
+    clearance       = fminf(clearance, nearest - OBSTACLE_RADIUS);
+    if (clearance <= 0)
+        return max_substeps;
+
+    float count = ceilf(travel / (params->substep_tolerance * clearance));
+    return count < max_substeps ? (int)count : max_substeps;
+}
+
+// Advances the motion by one substep of the integrator chosen in the config,
+// then sweeps it against the walls and obstacles
+static void substep(const struct field *field, struct motion *motion,
+                    float h) {
+    struct pos from        = motion->position;
+    struct velocity before = motion->velocity;
+    struct force force     = total_force(field, from, before);
+    integrators[field->params->integrator](field, motion, force, h);
+
+    // Prevent small floating-point values from preventing the velocity from
+    // reaching zero. A threshold is applied only when no external forces
+    // are acting on the drone.
+    if (fabs(before.x_component) < ZERO_THRESHOLD &&
+        force.x_component == 0) {
+        motion->position.x           = from.x;
+        motion->velocity.x_component = 0;
+    }
+    if (fabs(before.y_component) < ZERO_THRESHOLD &&
+        force.y_component == 0) {
+        motion->position.y           = from.y;
+        motion->velocity.y_component = 0;
+    }
+
+    // Follow the substep from the previous position instead of clamping the
+    // new one: a large force or time step could otherwise carry the drone
+    // through a wall or an obstacle between two samples of their fields.
+    // After an impact the velocity is the reflected one, and the previous
+    // position the one the drone would have come from with it.
+    struct pos step = {motion->velocity.x_component * h,
+                       motion->velocity.y_component * h};
+    motion->last    = from;
+    if (resolve_collisions(from, &motion->position, &step,
+                           field->obstacles)) {
+        motion->velocity.x_component = step.x / h;
+        motion->velocity.y_component = step.y / h;
+        motion->last.x               = motion->position.x - step.x;
+        motion->last.y               = motion->position.y - step.y;
+    }
+}
+
+// Advances the drone by one time step under the user force, the fields of the
+// obstacles and targets indexed in the grids and the repulsion of the walls.
+// The step is split in substeps close to the walls and obstacles, see
+// substep_count. The profiles of the fields are read from the tables if they
+// are enabled, and the walls and obstacles from the static field if one is
+// given.
+void physics_step(struct drone_body *body, const struct drone_config *params,
+                  struct force user_force, const struct spatial_grid *obstacles,
+                  const struct spatial_grid *targets,
+                  const struct force_luts *luts,
+                  const struct potential_field *potential) {
+    float T              = params->time_step; // Simulation time step
+    struct field field   = {params, user_force, obstacles, targets,
+                            luts->enabled ? luts : NULL, potential};
+    struct motion motion = {body->prev, body->prev2, body->velocity};
+
+    // The Verlet history is kept one time step apart, it is moved to one
+    // substep apart along the current velocity
+    int count = substep_count(&field, &motion, T);
+    float h   = T / count;
+    if (count > 1) {
+        motion.last.x = motion.position.x - motion.velocity.x_component * h;
+        motion.last.y = motion.position.y - motion.velocity.y_component * h;
+    }
+
+    for (int i = 0; i < count; i++)
+        substep(&field, &motion, h);
+
+    // The velocity is the one of the last substep, so that the displayed
+    // velocity is as up-to-date as possible. There is a slight delay of one
+    // iteration in detecting velocity zero, but this does not significantly
+    // affect the simulation.
+    body->position = motion.position;
+    body->velocity = motion.velocity;
+
+    // Update time-dependent position variables for the next iteration.
+    body->prev2 = motion.last;
+    if (count > 1) {
+        body->prev2.x = motion.position.x - motion.velocity.x_component * T;
+        body->prev2.y = motion.position.y - motion.velocity.y_component * T;
+    }
+    body->prev = motion.position;
+}
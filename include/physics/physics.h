@@ -0,0 +1,29 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include "config/config.h"
+#include "droneDataStructs.h"
+#include "grid/grid.h"
+#include "lut/lut.h"
+#include "potential/potential.h"
+
+// State of the drone integrator. The next position is computed from the two
+// previous ones, the velocity from the last displacement.
+struct drone_body {
+    struct pos position;
+    struct velocity velocity;
+    struct pos prev;
+    struct pos prev2;
+};
+
+float compute_repulsive_force(float distance, float function_scale,
+                              float area_of_effect, float vel_x, float vel_y);
+
+void physics_init(struct drone_body *body, float x, float y);
+void physics_step(struct drone_body *body, const struct drone_config *params,
+                  struct force user_force, const struct spatial_grid *obstacles,
+                  const struct spatial_grid *targets,
+                  const struct force_luts *luts,
+                  const struct potential_field *potential);
+
+#endif // !PHYSICS_H
@@ -0,0 +1,203 @@
+#include "potential/potential.h"
+#include "grid/grid.h"
+#include "utility/utility.h"
+#include <stdlib.h>
+
+// Repulsion of one wall at the given distance for a unit speed, as given by
+// compute_repulsive_force. The nodes on the border, which the drone never
+// reaches, take the value at WALL_MARGIN instead of an infinite one.
+static float wall_profile(float distance, const struct drone_config *params) {
+    if (distance >= params->area_of_effect)
+        return 0;
+    if (distance < WALL_MARGIN)
+        distance = WALL_MARGIN;
+    return params->function_scale *
+           ((1 / distance) - (1 / params->area_of_effect)) *
+           (1 / (distance * distance));
+}
+
+// Evaluates the fields at every node, visiting only the obstacles of the
+// neighbouring cells of the grid
+void potential_build(struct potential_field *field,
+                     const struct entity_store *obstacles,
+                     const struct drone_config *params) {
+    struct spatial_grid grid;
+    grid_build(&grid, obstacles, params->obst_of_effect);
+
+    for (int row = 0; row < POTENTIAL_ROWS; row++) {
+        float wall_y = wall_profile(row, params) -
+                       wall_profile(SIMULATION_HEIGHT - row, params);
+        for (int col = 0; col < POTENTIAL_COLS; col++) {
+            struct potential_node *node = &field->nodes[row][col];
+
+            node->obstacles         = grid_field_force(&grid, col, row, 1,
+                                                       params->obst_of_effect,
+                                                       NULL);
+            node->walls.x_component =
+                wall_profile(col, params) -
+                wall_profile(SIMULATION_WIDTH - col, params);
+            node->walls.y_component = wall_y;
+        }
+    }
+}
+
+// Bilinear interpolation of the four nodes around (x, y), clamped to the
+// simulation area
+struct potential_node potential_sample(const struct potential_field *field,
+                                       float x, float y) {
+    x = x < 0 ? 0 : x > SIMULATION_WIDTH ? SIMULATION_WIDTH : x;
+    y = y < 0 ? 0 : y > SIMULATION_HEIGHT ? SIMULATION_HEIGHT : y;
+
+    int col  = (int)x < POTENTIAL_COLS - 1 ? (int)x : POTENTIAL_COLS - 2;
+    int row  = (int)y < POTENTIAL_ROWS - 1 ? (int)y : POTENTIAL_ROWS - 2;
+    float fx = x - col;
+    float fy = y - row;
+
+    const struct potential_node *n00 = &field->nodes[row][col];
+    const struct potential_node *n01 = &field->nodes[row][col + 1];
+    const struct potential_node *n10 = &field->nodes[row + 1][col];
+    const struct potential_node *n11 = &field->nodes[row + 1][col + 1];
+
+    float w00 = (1 - fx) * (1 - fy);
+    float w01 = fx * (1 - fy);
+    float w10 = (1 - fx) * fy;
+    float w11 = fx * fy;
+
+    struct potential_node sample;
+    sample.obstacles.x_component =
+        w00 * n00->obstacles.x_component + w01 * n01->obstacles.x_component +
+        w10 * n10->obstacles.x_component + w11 * n11->obstacles.x_component;
+    sample.obstacles.y_component =
+        w00 * n00->obstacles.y_component + w01 * n01->obstacles.y_component +
+        w10 * n10->obstacles.y_component + w11 * n11->obstacles.y_component;
+    sample.walls.x_component =
+        w00 * n00->walls.x_component + w01 * n01->walls.x_component +
+        w10 * n10->walls.x_component + w11 * n11->walls.x_component;
+    sample.walls.y_component =
+        w00 * n00->walls.y_component + w01 * n01->walls.y_component +
+        w10 * n10->walls.y_component + w11 * n11->walls.y_component;
+    return sample;
+}
+
+// Builds the latest request each time the back field is free. A request
+// superseded during its build is not swapped in, the newer one is built
+// right after.
+static void *builder_loop(void *arg) {
+    struct potential_builder *builder = arg;
+    struct entity_store obstacles;
+    struct drone_config params;
+
+    pthread_mutex_lock(&builder->lock);
+    while (true) {
+        while (!builder->stopping &&
+               (!builder->pending || atomic_load(&builder->swap)))
+            pthread_cond_wait(&builder->wake, &builder->lock);
+        if (builder->stopping)
+            break;
+
+        obstacles             = builder->obstacles;
+        params                = builder->params;
+        unsigned long version = builder->requested;
+        builder->pending      = false;
+        pthread_mutex_unlock(&builder->lock);
+
+        potential_build(builder->back, &obstacles, &params);
+
+        pthread_mutex_lock(&builder->lock);
+        if (version == builder->requested) {
+            builder->back_version = version;
+            atomic_store(&builder->swap, true);
+        }
+    }
+    pthread_mutex_unlock(&builder->lock);
+    return NULL;
+}
+
+void potential_init(struct potential_builder *builder) {
+    pthread_mutex_init(&builder->lock, NULL);
+    pthread_cond_init(&builder->wake, NULL);
+    builder->started   = false;
+    builder->enabled   = false;
+    builder->requested = 0;
+    builder->pending   = false;
+    builder->stopping  = false;
+
+    builder->front         = builder->back = NULL;
+    builder->front_version = builder->back_version = 0;
+    atomic_init(&builder->swap, false);
+}
+
+// Starts the thread and allocates the fields, the first time the static
+// field is enabled. Returns false if they are not available.
+static bool builder_start(struct potential_builder *builder) {
+    if (builder->started)
+        return true;
+
+    builder->front = malloc(sizeof(struct potential_field));
+    builder->back  = malloc(sizeof(struct potential_field));
+    if (!builder->front || !builder->back ||
+        pthread_create(&builder->thread, NULL, builder_loop, builder) != 0) {
+        logging("WARN", "Static field not available, obstacles evaluated "
+                        "directly");
+        free(builder->front);
+        free(builder->back);
+        builder->front = builder->back = NULL;
+        return false;
+    }
+    builder->started = true;
+    return true;
+}
+
+// Asks for the field of a new set of obstacles or of new parameters. It is
+// used only once built, see potential_current.
+void potential_request(struct potential_builder *builder,
+                       const struct entity_store *obstacles,
+                       const struct drone_config *params) {
+    builder->enabled = params->static_field && builder_start(builder);
+    if (!builder->enabled)
+        return;
+
+    pthread_mutex_lock(&builder->lock);
+    builder->obstacles = *obstacles;
+    builder->params    = *params;
+    builder->requested++;
+    builder->pending = true;
+    pthread_cond_signal(&builder->wake);
+    pthread_mutex_unlock(&builder->lock);
+}
+
+// Called by the owner between two steps. Swaps in the field completed by the
+// thread, if any, and returns the field of the latest request, or NULL if it
+// is not built yet or the static field is disabled.
+const struct potential_field *
+potential_current(struct potential_builder *builder) {
+    if (atomic_load_explicit(&builder->swap, memory_order_acquire)) {
+        pthread_mutex_lock(&builder->lock);
+        struct potential_field *built = builder->back;
+        builder->back                 = builder->front;
+        builder->front                = built;
+        builder->front_version        = builder->back_version;
+        atomic_store(&builder->swap, false);
+        pthread_cond_signal(&builder->wake);
+        pthread_mutex_unlock(&builder->lock);
+    }
+
+    // The requests are made by the owner, so requested is read without lock
+    if (!builder->enabled || builder->front_version != builder->requested)
+        return NULL;
+    return builder->front;
+}
+
+void potential_destroy(struct potential_builder *builder) {
+    if (builder->started) {
+        pthread_mutex_lock(&builder->lock);
+        builder->stopping = true;
+        pthread_cond_signal(&builder->wake);
+        pthread_mutex_unlock(&builder->lock);
+        pthread_join(builder->thread, NULL);
+        free(builder->front);
+        free(builder->back);
+    }
+    pthread_mutex_destroy(&builder->lock);
+    pthread_cond_destroy(&builder->wake);
+}
@@ -0,0 +1,69 @@
+#ifndef POTENTIAL_H
+#define POTENTIAL_H
+
+#include "config/config.h"
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "forces/forces.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Nodes of the field on each side, one per simulation unit
+#define POTENTIAL_COLS (SIMULATION_WIDTH + 1)
+#define POTENTIAL_ROWS (SIMULATION_HEIGHT + 1)
+
+// Static part of the fields at a node, for a unit speed. The obstacles and
+// the walls are kept apart because only the force of the obstacles is capped.
+struct potential_node {
+    struct force obstacles; // Sum of field_force over the obstacles
+    struct force walls;     // Repulsion of the walls
+};
+
+// Repulsive field of the walls and of one set of obstacles rasterized over
+// the simulation area, sampled with bilinear interpolation
+struct potential_field {
+    struct potential_node nodes[POTENTIAL_ROWS][POTENTIAL_COLS];
+};
+
+// Rasterizes the field of each new set of obstacles in a background thread.
+// The owner samples the front field while the thread writes the back one,
+// and swaps them between two steps once the back one is complete. Until the
+// field of the latest set is ready, the owner evaluates the obstacles
+// directly.
+struct potential_builder {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool started;
+    bool enabled; // static_field of the config, read by the owner only
+
+    // Latest request, guarded by the lock
+    struct entity_store obstacles;
+    struct drone_config params;
+    unsigned long requested; // Number of the latest request
+    bool pending;
+    bool stopping;
+
+    struct potential_field *front;
+    struct potential_field *back;
+    unsigned long front_version; // Request the front field was built for
+    unsigned long back_version;
+    atomic_bool swap; // The back field is complete and waits for the owner
+};
+
+void potential_build(struct potential_field *field,
+                     const struct entity_store *obstacles,
+                     const struct drone_config *params);
+struct potential_node potential_sample(const struct potential_field *field,
+                                       float x, float y);
+
+void potential_init(struct potential_builder *builder);
+void potential_request(struct potential_builder *builder,
+                       const struct entity_store *obstacles,
+                       const struct drone_config *params);
+const struct potential_field *
+potential_current(struct potential_builder *builder);
+void potential_destroy(struct potential_builder *builder);
+
+#endif // !POTENTIAL_H
@@ -0,0 +1,97 @@
+#include "protocol/protocol.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+
+// Reads exactly nbytes from fd. Frames bigger than PIPE_BUF may be split by
+// the kernel, so short reads are completed here. Returns 0 if the pipe has
+// been closed before the first byte.
+static int read_exact(int fd, void *buf, size_t nbytes) {
+    size_t done = 0;
+    while (done < nbytes) {
+        int ret = Read(fd, (char *)buf + done, nbytes - done);
+        if (ret == 0)
+            return 0;
+        done += ret;
+    }
+    return done;
+}
+
+// Sends header and payload with a single write so that frames coming from
+// different processes can never interleave on the same pipe
+void send_msg(int fd, uint16_t type, const void *payload, uint16_t length) {
+    struct msg frame;
+    frame.header.type   = type;
+    frame.header.length = length;
+    frame.header.drone  = DRONE_ALL;
+    if (length > 0)
+        memcpy(&frame.payload, payload, length);
+    Write(fd, &frame, sizeof(struct msg_header) + length);
+}
+
+// Receives a whole frame. Returns 0 if the pipe has been closed, the size of the
+// frame otherwise.
+int recv_msg(int fd, struct msg *msg) {
+    if (read_exact(fd, &msg->header, sizeof(struct msg_header)) == 0)
+        return 0;
+
+    if (msg->header.length > sizeof(msg->payload)) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Malformed frame of type %d and length %d, pid: %d",
+                msg->header.type, msg->header.length, getpid());
+        logging("ERROR", logmsg);
+        exit(EXIT_FAILURE);
+    }
+
+    if (msg->header.length > 0 &&
+        read_exact(fd, &msg->payload, msg->header.length) == 0)
+        return 0;
+    return sizeof(struct msg_header) + msg->header.length;
+}
+
+// Sends a received frame as it is to another process
+void forward_msg(int fd, const struct msg *msg) {
+    send_msg(fd, msg->header.type, &msg->payload, msg->header.length);
+}
+
+void batch_init(struct msg *batch) {
+    batch->header.type   = MSG_BATCH;
+    batch->header.length = 0;
+    batch->header.drone  = DRONE_ALL;
+}
+
+// Appends a whole frame, header included, to a batch. Returns false if the
+// batch has no room left for it.
+bool batch_append(struct msg *batch, const struct msg *frame) {
+    uint16_t size = sizeof(struct msg_header) + frame->header.length;
+    if (batch->header.length + size > MAX_BATCH_LEN)
+        return false;
+
+    memcpy(batch->payload.batch + batch->header.length, frame, size);
+    batch->header.length += size;
+    return true;
+}
+
+// Extracts the frame starting at offset and moves offset past it. Returns
+// false once the whole batch has been consumed.
+bool batch_next(const struct msg *batch, uint16_t *offset, struct msg *frame) {
+    if (*offset + sizeof(struct msg_header) > batch->header.length)
+        return false;
+
+    memcpy(&frame->header, batch->payload.batch + *offset,
+           sizeof(struct msg_header));
+    if (frame->header.length > sizeof(frame->payload) ||
+        *offset + sizeof(struct msg_header) + frame->header.length >
+            batch->header.length) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Malformed batch at offset %d, pid: %d", *offset,
+                getpid());
+        logging("ERROR", logmsg);
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(&frame->payload,
+           batch->payload.batch + *offset + sizeof(struct msg_header),
+           frame->header.length);
+    *offset += sizeof(struct msg_header) + frame->header.length;
+    return true;
+}
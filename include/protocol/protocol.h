@@ -0,0 +1,100 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "constants.h"
+#include "droneDataStructs.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Type tag carried by every frame exchanged on the pipes
+enum msg_type {
+    MSG_STOP = 1,    // Orderly shutdown request, no payload
+    MSG_FORCE,       // Force applied by the user (input -> server -> drone)
+    MSG_TARGETS,     // New set of targets
+    MSG_OBSTACLES,   // New set of obstacles
+    MSG_TARGET_HIT,  // A target has been reached (map -> server -> drone)
+    MSG_GENERATE,    // New targets request (map -> server -> target)
+    MSG_BATCH,       // Several whole frames coalesced by the server
+    MSG_SUBSCRIBE,   // Telemetry requested by a client (client -> server)
+    MSG_DRONE_STATE, // State of the drone of the header (server -> client)
+    MSG_SCORE        // Current score (server -> client)
+};
+
+// Drone ID of the frames concerning every drone
+#define DRONE_ALL UINT32_MAX
+
+// Fixed size header preceding every payload. The length is the number of
+// payload bytes following the header, so the receiver never has to parse text
+// to know where a frame ends. The drone is the ID of the drone the frame is
+// addressed to or coming from, DRONE_ALL if it concerns all of them.
+struct msg_header {
+    uint16_t type;
+    uint16_t length;
+    uint32_t drone;
+};
+
+// Set of targets or obstacles, only the first count items are sent
+struct entity_set {
+    uint32_t count;
+    struct pos items[MAX_ENTITIES];
+};
+
+// Index of the hit target in the map array and its position
+struct target_hit {
+    uint32_t index;
+    struct pos position;
+};
+
+// Topics of the telemetry, a subscription holds a mask of them
+enum telemetry_topic {
+    TOPIC_DRONE_STATE = 1 << 0,
+    TOPIC_TARGETS     = 1 << 1,
+    TOPIC_OBSTACLES   = 1 << 2,
+    TOPIC_SCORE       = 1 << 3
+};
+
+// Telemetry requested by a client. The server pushes the subscribed topics at
+// most once per period, each one only if it changed since the last push. The
+// drone selects the states pushed, DRONE_ALL for every drone. A subscription
+// replaces the previous one of the client, no topics cancels it.
+struct subscription {
+    uint32_t topics;
+    uint32_t period_us;
+    uint32_t drone;
+};
+
+// Largest batch: the newest force, target set and obstacle set, each one with
+// its own header
+#define MAX_BATCH_LEN                                                          \
+    (3 * sizeof(struct msg_header) + sizeof(struct force) +                    \
+     2 * sizeof(struct entity_set))
+
+// A complete frame as it is stored once received
+struct msg {
+    struct msg_header header;
+    union {
+        struct force force;
+        struct entity_set set;
+        struct target_hit hit;
+        struct subscription subscription;
+        struct drone_state state;
+        int32_t score;
+        uint8_t batch[MAX_BATCH_LEN];
+    } payload;
+};
+
+// Size on the wire of an entity set payload holding count items
+#define ENTITY_SET_SIZE(count)                                                 \
+    ((uint16_t)(offsetof(struct entity_set, items) +                           \
+                (count) * sizeof(struct pos)))
+
+void send_msg(int fd, uint16_t type, const void *payload, uint16_t length);
+int recv_msg(int fd, struct msg *msg);
+void forward_msg(int fd, const struct msg *msg);
+
+void batch_init(struct msg *batch);
+bool batch_append(struct msg *batch, const struct msg *frame);
+bool batch_next(const struct msg *batch, uint16_t *offset, struct msg *frame);
+
+#endif // !PROTOCOL_H
@@ -0,0 +1,70 @@
+#include "reactor/reactor.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <sys/epoll.h>
+
+void reactor_init(struct reactor *reactor) {
+    reactor->epfd        = Epoll_create1(0);
+    reactor->running     = false;
+    reactor->sources_num = 0;
+}
+
+// Registers fd as edge-triggered, so that a wakeup costs O(1) whatever the
+// number and the values of the monitored file descriptors
+void reactor_add(struct reactor *reactor, int fd, reactor_handler on_ready,
+                 reactor_prepare prepare, void *context) {
+    if (reactor->sources_num == REACTOR_MAX_SOURCES) {
+        logging("ERROR", "Too many sources registered in the reactor");
+        exit(EXIT_FAILURE);
+    }
+
+    int index                        = reactor->sources_num++;
+    reactor->sources[index].fd       = fd;
+    reactor->sources[index].on_ready = on_ready;
+    reactor->sources[index].prepare  = prepare;
+    reactor->sources[index].context  = context;
+
+    struct epoll_event event;
+    event.events   = EPOLLIN | EPOLLET;
+    event.data.u32 = index;
+    Epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, fd, &event);
+}
+
+// Dispatches events until reactor_stop is called by a handler. SIGUSR1 is not
+// masked while sleeping, so the watchdog ping interrupts the wait and the loop
+// simply starts a new round.
+void reactor_run(struct reactor *reactor) {
+    struct epoll_event events[REACTOR_MAX_SOURCES];
+    bool prepared[REACTOR_MAX_SOURCES];
+    bool signaled[REACTOR_MAX_SOURCES];
+
+    reactor->running = true;
+    while (reactor->running) {
+        // Sleep only if no source has pending work
+        bool can_sleep = true;
+        for (int i = 0; i < reactor->sources_num; i++) {
+            struct reactor_source *source = &reactor->sources[i];
+            prepared[i] = source->prepare != NULL;
+            signaled[i] = false;
+            if (prepared[i] && !source->prepare(source->context))
+                can_sleep = false;
+        }
+
+        int ready = Epoll_wait(reactor->epfd, events, REACTOR_MAX_SOURCES,
+                               can_sleep ? -1 : 0);
+        for (int i = 0; i < ready; i++)
+            signaled[events[i].data.u32] = true;
+
+        // Sources with a prepare hook are always called back to close the
+        // wait, the others only when their fd is readable
+        for (int i = 0; i < reactor->sources_num && reactor->running; i++) {
+            struct reactor_source *source = &reactor->sources[i];
+            if (prepared[i] || signaled[i])
+                source->on_ready(reactor, source->context, signaled[i]);
+        }
+    }
+}
+
+void reactor_stop(struct reactor *reactor) { reactor->running = false; }
+
+void reactor_close(struct reactor *reactor) { Close(reactor->epfd); }
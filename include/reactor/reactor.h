@@ -0,0 +1,44 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <stdbool.h>
+
+// Maximum number of file descriptors a reactor can monitor, enough for the
+// rings and the relay timers of the server with MAX_DRONES drones
+#define REACTOR_MAX_SOURCES 512
+
+struct reactor;
+
+// Called when the source is ready. signaled is true if its file descriptor
+// became readable: the fd is registered edge-triggered, so the handler must
+// consume it until EAGAIN, otherwise no new event is reported.
+typedef void (*reactor_handler)(struct reactor *reactor, void *context,
+                                bool signaled);
+
+// Optional hook called before sleeping. Returns false if the source already
+// has pending work, in which case the reactor only polls and calls the handler
+// even without an event on the fd.
+typedef bool (*reactor_prepare)(void *context);
+
+struct reactor_source {
+    int fd;
+    reactor_handler on_ready;
+    reactor_prepare prepare;
+    void *context;
+};
+
+struct reactor {
+    int epfd;
+    bool running;
+    int sources_num;
+    struct reactor_source sources[REACTOR_MAX_SOURCES];
+};
+
+void reactor_init(struct reactor *reactor);
+void reactor_add(struct reactor *reactor, int fd, reactor_handler on_ready,
+                 reactor_prepare prepare, void *context);
+void reactor_run(struct reactor *reactor);
+void reactor_stop(struct reactor *reactor);
+void reactor_close(struct reactor *reactor);
+
+#endif // !REACTOR_H
@@ -0,0 +1,124 @@
+#include "relay/relay.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <sys/timerfd.h>
+#include <time.h>
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// Returns the slot replaced by a frame of the given type, -1 for events
+static int relay_slot(uint16_t type) {
+    switch (type) {
+        case MSG_FORCE:
+            return RELAY_FORCE;
+        case MSG_TARGETS:
+            return RELAY_TARGETS;
+        case MSG_OBSTACLES:
+            return RELAY_OBSTACLES;
+        default:
+            return -1;
+    }
+}
+
+void relay_init(struct relay *relay, struct channel *channel, long period_us) {
+    relay->channel       = channel;
+    relay->tfd           = Timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    relay->period_ns     = (uint64_t)period_us * 1000;
+    relay->last_flush_ns = 0;
+    relay->armed         = false;
+    relay->pending       = 0;
+}
+
+// Arms the timer to fire at the absolute monotonic time deadline_ns
+static void relay_arm(struct relay *relay, uint64_t deadline_ns) {
+    struct itimerspec spec = {{0, 0},
+                              {deadline_ns / 1000000000ull,
+                               deadline_ns % 1000000000ull}};
+    Timerfd_settime(relay->tfd, TFD_TIMER_ABSTIME, &spec, NULL);
+    relay->armed = true;
+}
+
+// Packs the pending frames. A single pending frame is sent as it is.
+static void relay_pack(struct relay *relay, struct msg *out) {
+    int count = 0, last = 0;
+    batch_init(out);
+    for (int i = 0; i < RELAY_SLOTS; i++)
+        if (relay->pending & (1u << i)) {
+            batch_append(out, &relay->slots[i]);
+            count++;
+            last = i;
+        }
+
+    if (count == 1)
+        *out = relay->slots[last];
+}
+
+// Tries to send the pending state without blocking. If the consumer ring is
+// full the state stays pending, newer frames keep replacing it, and the flush
+// is retried one period later: a slow consumer never stalls the server.
+static void relay_flush(struct relay *relay) {
+    struct msg out;
+    relay_pack(relay, &out);
+
+    uint64_t now = now_ns();
+    if (channel_try_forward(relay->channel, &out)) {
+        relay->pending       = 0;
+        relay->last_flush_ns = now;
+    } else {
+        relay_arm(relay, now + relay->period_ns);
+    }
+}
+
+// Queues a frame for the consumer
+void relay_post(struct relay *relay, const struct msg *frame) {
+    int slot = relay_slot(frame->header.type);
+    if (slot < 0) {
+        // Events must follow the state they refer to, so the pending state is
+        // sent first, waiting for room if needed
+        if (relay->pending) {
+            struct msg out;
+            relay_pack(relay, &out);
+            channel_forward(relay->channel, &out);
+            relay->pending       = 0;
+            relay->last_flush_ns = now_ns();
+        }
+        channel_forward(relay->channel, frame);
+        return;
+    }
+
+    relay->slots[slot] = *frame;
+    relay->pending |= 1u << slot;
+
+    // Flush right away if the period has already elapsed, otherwise wait for
+    // the timer that will pick up every frame arrived in the meantime
+    if (relay->armed)
+        return;
+    uint64_t deadline = relay->last_flush_ns + relay->period_ns;
+    if (now_ns() >= deadline)
+        relay_flush(relay);
+    else
+        relay_arm(relay, deadline);
+}
+
+// Called when the timer file descriptor is readable
+void relay_expire(struct relay *relay) {
+    uint64_t expirations;
+    if (read(relay->tfd, &expirations, sizeof(expirations)) < 0 &&
+        errno != EAGAIN) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg, "Error on reading timerfd %d: %s, pid: %d", relay->tfd,
+                strerror(errno), getpid());
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+
+    relay->armed = false;
+    if (relay->pending)
+        relay_flush(relay);
+}
+
+void relay_close(struct relay *relay) { Close(relay->tfd); }
@@ -0,0 +1,31 @@
+#ifndef RELAY_H
+#define RELAY_H
+
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frames holding a state that a newer frame of the same type replaces
+enum relay_slot { RELAY_FORCE, RELAY_TARGETS, RELAY_OBSTACLES, RELAY_SLOTS };
+
+// Coalescing stage in front of one consumer. State frames are kept in their
+// slot until the next flush, which sends all of them as a single batch at most
+// once per period. Event frames are never coalesced: they flush the pending
+// state and are sent right after it, preserving their order.
+struct relay {
+    struct channel *channel;
+    int tfd;                // One-shot timer of the next allowed flush
+    uint64_t period_ns;     // Minimum time between two flushes
+    uint64_t last_flush_ns; // Monotonic time of the last flush
+    bool armed;
+    unsigned pending; // Bitmask of the slots holding an unsent frame
+    struct msg slots[RELAY_SLOTS];
+};
+
+void relay_init(struct relay *relay, struct channel *channel, long period_us);
+void relay_post(struct relay *relay, const struct msg *frame);
+void relay_expire(struct relay *relay);
+void relay_close(struct relay *relay);
+
+#endif // !RELAY_H
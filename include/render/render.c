@@ -0,0 +1,137 @@
+#include "render/render.h"
+#include <string.h>
+
+// Sets the area of the free cells to the inside of the window, and clears it
+static void occupancy_resize(struct occupancy *o, int lines, int cols) {
+    o->lines = lines < RENDER_MAX_LINES - 1 ? lines : RENDER_MAX_LINES - 1;
+    o->cols  = cols < RENDER_MAX_COLS - 1 ? cols : RENDER_MAX_COLS - 1;
+    memset(o->bits, 0, sizeof(o->bits));
+}
+
+static void occupancy_clear(struct occupancy *o) {
+    for (int y = 1; y <= o->lines; y++)
+        memset(o->bits[y], 0, (o->cols / 64 + 1) * sizeof(uint64_t));
+}
+
+// True if the cell is taken or outside the window
+bool occupancy_taken(const struct occupancy *o, int y, int x) {
+    if (y < 1 || x < 1 || y > o->lines || x > o->cols)
+        return true;
+    return o->bits[y][x / 64] >> (x % 64) & 1;
+}
+
+void occupancy_take(struct occupancy *o, int y, int x) {
+    if (!occupancy_taken(o, y, x))
+        o->bits[y][x / 64] |= (uint64_t)1 << (x % 64);
+}
+
+// Moves (y, x) to the nearest free cell other than (avoid_y, avoid_x),
+// searching squares of growing size around it. Returns false if the window
+// is full.
+bool occupancy_find_free(const struct occupancy *o, int *y, int *x,
+                         int avoid_y, int avoid_x) {
+    int cy = *y, cx = *x;
+    int max_radius = o->lines > o->cols ? o->lines : o->cols;
+    for (int radius = 1; radius <= max_radius; radius++) {
+        // Top and bottom rows of the square, then its left and right columns
+        for (int side = 0; side < 4; side++) {
+            int len = side < 2 ? 2 * radius + 1 : 2 * radius - 1;
+            for (int k = 0; k < len; k++) {
+                int ty, tx;
+                if (side < 2) {
+                    ty = side == 0 ? cy - radius : cy + radius;
+                    tx = cx - radius + k;
+                } else {
+                    ty = cy - radius + 1 + k;
+                    tx = side == 2 ? cx - radius : cx + radius;
+                }
+                if (!occupancy_taken(o, ty, tx) &&
+                    (ty != avoid_y || tx != avoid_x)) {
+                    *y = ty;
+                    *x = tx;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Builds the map window below the title line and draws its border. The cells
+// on the screen are forgotten, since the whole terminal is cleared.
+static void build_window(struct renderer *r) {
+    if (r->win)
+        delwin(r->win);
+    r->lines = LINES;
+    r->cols  = COLS;
+    r->win   = newwin(LINES - 1, COLS, 1, 0);
+    clear();
+    box(r->win, 0, 0);
+    occupancy_resize(&r->occupied, LINES - 3, COLS - 2);
+
+    for (int i = 0; i < r->shown_num; i++)
+        r->shown[r->shown_cells[i].y][r->shown_cells[i].x] = 0;
+    r->shown_num = 0;
+    r->resized   = true;
+}
+
+void render_init(struct renderer *r) {
+    r->win       = NULL;
+    r->shown_num = r->next_num = 0;
+    build_window(r);
+}
+
+// Starts a new frame, rebuilding the window if the terminal was resized
+void render_begin(struct renderer *r) {
+    r->resized = false;
+    if (r->lines != LINES || r->cols != COLS)
+        build_window(r);
+    r->next_num = 0;
+    occupancy_clear(&r->occupied);
+}
+
+// Draws a glyph in the frame. A later glyph in the same cell replaces the
+// previous one, as drawing over it would do.
+void render_put(struct renderer *r, int y, int x, chtype glyph) {
+    if (y < 0 || x < 0 || y >= RENDER_MAX_LINES || x >= RENDER_MAX_COLS)
+        return;
+    if (r->next[y][x] == 0) {
+        if (r->next_num == RENDER_MAX_GLYPHS)
+            return;
+        r->next_cells[r->next_num++] = (struct render_cell){y, x};
+    }
+    r->next[y][x] = glyph;
+}
+
+// Erases the cells left empty, draws the ones that changed and updates the
+// terminal with a single write
+void render_end(struct renderer *r) {
+    for (int i = 0; i < r->shown_num; i++) {
+        struct render_cell c = r->shown_cells[i];
+        if (r->next[c.y][c.x] == 0) {
+            mvwaddch(r->win, c.y, c.x, ' ');
+            r->shown[c.y][c.x] = 0;
+        }
+    }
+    for (int i = 0; i < r->next_num; i++) {
+        struct render_cell c = r->next_cells[i];
+        if (r->shown[c.y][c.x] != r->next[c.y][c.x]) {
+            mvwaddch(r->win, c.y, c.x, r->next[c.y][c.x]);
+            r->shown[c.y][c.x] = r->next[c.y][c.x];
+        }
+        r->next[c.y][c.x] = 0;
+        r->shown_cells[i] = c;
+    }
+    r->shown_num = r->next_num;
+
+    // The title line of stdscr goes first, the map window is drawn over it
+    wnoutrefresh(stdscr);
+    wnoutrefresh(r->win);
+    doupdate();
+}
+
+void render_close(struct renderer *r) {
+    if (r->win)
+        delwin(r->win);
+    r->win = NULL;
+}
@@ -0,0 +1,63 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "constants.h"
+#include <curses.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest window handled by the renderer, cells beyond it are not drawn
+#define RENDER_MAX_LINES 256
+#define RENDER_MAX_COLS 512
+// Glyphs drawn in a frame: every target, obstacle and drone
+#define RENDER_MAX_GLYPHS (N_TARGETS + N_OBSTACLES + MAX_DRONES)
+
+struct render_cell {
+    int y;
+    int x;
+};
+
+// One bit per cell of the inside of the map window, set when a target or an
+// obstacle is drawn there. The lookups are O(1). Only the rows inside the
+// window are cleared at each frame, and the area changes only on resize.
+struct occupancy {
+    int lines; // Free cells are in [1, lines] x [1, cols]
+    int cols;
+    uint64_t bits[RENDER_MAX_LINES][RENDER_MAX_COLS / 64];
+};
+
+// Incremental renderer of a boxed window. A frame is composed with
+// render_put, then render_end compares it with the previous one: only the
+// cells whose glyph changed are erased or drawn, and the terminal is updated
+// once. The window is kept between frames and rebuilt only on resize.
+struct renderer {
+    WINDOW *win;
+    int lines; // Size of the terminal when the window was built
+    int cols;
+    bool resized; // The window was rebuilt by the last render_begin
+
+    // Glyph of each cell on the screen and in the frame being composed,
+    // 0 when empty, with the list of the non empty cells
+    chtype shown[RENDER_MAX_LINES][RENDER_MAX_COLS];
+    chtype next[RENDER_MAX_LINES][RENDER_MAX_COLS];
+    struct render_cell shown_cells[RENDER_MAX_GLYPHS];
+    struct render_cell next_cells[RENDER_MAX_GLYPHS];
+    int shown_num;
+    int next_num;
+
+    // Cells taken in the frame being composed
+    struct occupancy occupied;
+};
+
+void render_init(struct renderer *r);
+void render_begin(struct renderer *r);
+void render_put(struct renderer *r, int y, int x, chtype glyph);
+void render_end(struct renderer *r);
+void render_close(struct renderer *r);
+
+bool occupancy_taken(const struct occupancy *o, int y, int x);
+void occupancy_take(struct occupancy *o, int y, int x);
+bool occupancy_find_free(const struct occupancy *o, int *y, int *x,
+                         int avoid_y, int avoid_x);
+
+#endif // !RENDER_H
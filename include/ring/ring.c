@@ -0,0 +1,256 @@
+#include "ring/ring.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+
+_Static_assert(sizeof(struct msg) < RING_CAPACITY,
+               "A whole frame must fit in a ring");
+
+// Time to wait before retrying to send on a full ring
+#define RING_FULL_BACKOFF_US 50
+
+// Creates the shared memory segment holding the rings. Called only by the
+// master before spawning the other processes.
+struct channel_table *channels_create(void) {
+    int fd = Shm_open(CHANNELS_SHM_NAME, O_CREAT | O_RDWR, 0666);
+    Ftruncate(fd, sizeof(struct channel_table));
+    struct channel_table *table =
+        Mmap(NULL, sizeof(struct channel_table), PROT_READ | PROT_WRITE,
+             MAP_SHARED, fd, 0);
+    Close(fd);
+
+    for (int i = 0; i < CH_COUNT; i++)
+        ring_init(&table->rings[i]);
+    for (int i = 0; i < MAX_DRONES; i++)
+        ring_init(&table->drone_rings[i]);
+    for (int i = 0; i < TELEMETRY_SLOTS; i++) {
+        ring_init(&table->telemetry_requests[i]);
+        ring_init(&table->telemetry_streams[i]);
+    }
+    return table;
+}
+
+// Maps the rings created by the master in the calling process
+struct channel_table *channels_open(void) {
+    int fd = Shm_open(CHANNELS_SHM_NAME, O_RDWR, 0666);
+    struct channel_table *table =
+        Mmap(NULL, sizeof(struct channel_table), PROT_READ | PROT_WRITE,
+             MAP_SHARED, fd, 0);
+    Close(fd);
+    return table;
+}
+
+void channels_close(struct channel_table *table) {
+    Munmap(table, sizeof(struct channel_table));
+}
+
+// Unmaps and removes the shared memory segment, called by the master at exit
+void channels_destroy(struct channel_table *table) {
+    channels_close(table);
+    Shm_unlink(CHANNELS_SHM_NAME);
+}
+
+void ring_init(struct spsc_ring *ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->consumer_idle, 0);
+}
+
+void channel_attach(struct channel *ch, struct spsc_ring *ring, int efd) {
+    ch->ring = ring;
+    ch->efd  = efd;
+    batch_init(&ch->batch);
+    ch->batch_offset = 0;
+}
+
+// Copies size bytes at the free running position pos, wrapping around the end
+// of the data area
+static void ring_copy_in(struct spsc_ring *ring, uint32_t pos, const void *src,
+                         uint32_t size) {
+    uint32_t offset = pos & (RING_CAPACITY - 1);
+    uint32_t first  = RING_CAPACITY - offset;
+    if (first > size)
+        first = size;
+    memcpy(ring->data + offset, src, first);
+    memcpy(ring->data, (const uint8_t *)src + first, size - first);
+}
+
+static void ring_copy_out(const struct spsc_ring *ring, uint32_t pos, void *dst,
+                          uint32_t size) {
+    uint32_t offset = pos & (RING_CAPACITY - 1);
+    uint32_t first  = RING_CAPACITY - offset;
+    if (first > size)
+        first = size;
+    memcpy(dst, ring->data + offset, first);
+    memcpy((uint8_t *)dst + first, ring->data, size - first);
+}
+
+// Wakes up the consumer if it is sleeping on the eventfd. The full fence pairs
+// with the one in channel_prepare_wait: either the consumer sees the new head
+// or the producer sees the idle flag.
+static void channel_notify(struct channel *ch) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_load_explicit(&ch->ring->consumer_idle, memory_order_relaxed))
+        return;
+
+    uint64_t one = 1;
+    if (write(ch->efd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg, "Error on ringing eventfd %d: %s, pid: %d", ch->efd,
+                strerror(errno), getpid());
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Appends a header and its payload to the ring. Returns false without
+// blocking if there is not enough free space.
+static bool ring_send(struct channel *ch, const struct msg_header *header,
+                      const void *payload) {
+    struct spsc_ring *ring = ch->ring;
+    uint32_t size          = sizeof(*header) + header->length;
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (RING_CAPACITY - (head - tail) < size)
+        return false;
+
+    ring_copy_in(ring, head, header, sizeof(*header));
+    if (header->length > 0)
+        ring_copy_in(ring, head + sizeof(*header), payload, header->length);
+    atomic_store_explicit(&ring->head, head + size, memory_order_release);
+
+    channel_notify(ch);
+    return true;
+}
+
+// Appends a frame concerning every drone to the ring. Returns false without
+// blocking if there is not enough free space.
+bool channel_try_send(struct channel *ch, uint16_t type, const void *payload,
+                      uint16_t length) {
+    return channel_try_send_to(ch, DRONE_ALL, type, payload, length);
+}
+
+// Same as channel_try_send for a frame addressed to or coming from one drone
+bool channel_try_send_to(struct channel *ch, uint32_t drone, uint16_t type,
+                         const void *payload, uint16_t length) {
+    struct msg_header header = {type, length, drone};
+    return ring_send(ch, &header, payload);
+}
+
+// Appends a frame to the ring, waiting for the consumer if the ring is full
+// like a write on a full pipe would do
+void channel_send(struct channel *ch, uint16_t type, const void *payload,
+                  uint16_t length) {
+    channel_send_to(ch, DRONE_ALL, type, payload, length);
+}
+
+// Same as channel_send for a frame addressed to or coming from one drone
+void channel_send_to(struct channel *ch, uint32_t drone, uint16_t type,
+                     const void *payload, uint16_t length) {
+    struct msg_header header = {type, length, drone};
+    while (!ring_send(ch, &header, payload))
+        usleep(RING_FULL_BACKOFF_US);
+}
+
+// Sends a received frame as it is to another process, without blocking
+bool channel_try_forward(struct channel *ch, const struct msg *msg) {
+    return ring_send(ch, &msg->header, &msg->payload);
+}
+
+// Sends a received frame as it is to another process
+void channel_forward(struct channel *ch, const struct msg *msg) {
+    while (!channel_try_forward(ch, msg))
+        usleep(RING_FULL_BACKOFF_US);
+}
+
+// Pops the oldest frame from the ring itself
+static bool ring_recv(struct channel *ch, struct msg *msg) {
+    struct spsc_ring *ring = ch->ring;
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail)
+        return false;
+
+    ring_copy_out(ring, tail, &msg->header, sizeof(msg->header));
+    if (msg->header.length > sizeof(msg->payload)) {
+        char logmsg[MAX_STR_LEN];
+        sprintf(logmsg, "Malformed frame of type %d and length %d, pid: %d",
+                msg->header.type, msg->header.length, getpid());
+        logging("ERROR", logmsg);
+        exit(EXIT_FAILURE);
+    }
+    ring_copy_out(ring, tail + sizeof(msg->header), &msg->payload,
+                  msg->header.length);
+
+    atomic_store_explicit(&ring->tail,
+                          tail + sizeof(msg->header) + msg->header.length,
+                          memory_order_release);
+    return true;
+}
+
+// Pops the oldest frame, unpacking batches. Returns false if the ring is
+// empty, never blocks.
+bool channel_recv(struct channel *ch, struct msg *msg) {
+    while (1) {
+        if (batch_next(&ch->batch, &ch->batch_offset, msg))
+            return true;
+        if (!ring_recv(ch, msg))
+            return false;
+        if (msg->header.type != MSG_BATCH)
+            return true;
+
+        // Keep the batch and hand out its frames starting from the first one
+        ch->batch        = *msg;
+        ch->batch_offset = 0;
+    }
+}
+
+bool channel_empty(struct channel *ch) {
+    return ch->batch_offset >= ch->batch.header.length &&
+           atomic_load_explicit(&ch->ring->head, memory_order_acquire) ==
+               atomic_load_explicit(&ch->ring->tail, memory_order_relaxed);
+}
+
+// Announces that the consumer is going to sleep on the eventfd. Returns false,
+// clearing the announcement, if a frame arrived in the meantime and sleeping
+// would lose it.
+bool channel_prepare_wait(struct channel *ch) {
+    atomic_store_explicit(&ch->ring->consumer_idle, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!channel_empty(ch)) {
+        atomic_store_explicit(&ch->ring->consumer_idle, 0,
+                              memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// Clears the idle flag after waking up. The eventfd counter is consumed only
+// if the producer actually rang it, so a busy consumer makes no syscall.
+void channel_finish_wait(struct channel *ch, bool signaled) {
+    atomic_store_explicit(&ch->ring->consumer_idle, 0, memory_order_relaxed);
+    if (signaled) {
+        uint64_t count;
+        if (read(ch->efd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+            char msg[MAX_STR_LEN];
+            sprintf(msg, "Error on reading eventfd %d: %s, pid: %d", ch->efd,
+                    strerror(errno), getpid());
+            logging("ERROR", msg);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Waits until a frame is available or the timeout (NULL to wait forever)
+// expires. Returns true if a frame can be received. Like select() it may
+// return early when a signal is caught.
+bool channel_wait(struct channel *ch, struct timeval *timeout) {
+    if (channel_prepare_wait(ch)) {
+        fd_set reader;
+        FD_ZERO(&reader);
+        FD_SET(ch->efd, &reader);
+        int ret = Select(ch->efd + 1, &reader, NULL, NULL, timeout);
+        channel_finish_wait(ch, ret > 0 && FD_ISSET(ch->efd, &reader));
+    }
+    return !channel_empty(ch);
+}
@@ -0,0 +1,87 @@
+#ifndef RING_H
+#define RING_H
+
+#include "constants.h"
+#include "protocol/protocol.h"
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+// Size in bytes of the data area of every ring, must be a power of two
+#define RING_CAPACITY (1 << 14)
+
+// Single producer single consumer byte ring holding whole protocol frames.
+// head and tail are free running counters, each one written by one side only
+// and kept on its own cache line to avoid false sharing.
+struct spsc_ring {
+    alignas(64) _Atomic uint32_t head;
+    alignas(64) _Atomic uint32_t tail;
+    // Set by the consumer before sleeping on the eventfd, the producer rings
+    // the eventfd only when this flag is set
+    _Atomic uint32_t consumer_idle;
+    alignas(64) uint8_t data[RING_CAPACITY];
+};
+
+// Identifiers of the rings replacing the pipes between the processes
+enum channel_id {
+    CH_INPUT_SERVER,
+    CH_MAP_SERVER,
+    CH_SERVER_MAP,
+    CH_TARGET_SERVER,
+    CH_SERVER_TARGET,
+    CH_OBSTACLE_SERVER,
+    CH_SERVER_OBSTACLE,
+    CH_COUNT
+};
+
+// Telemetry clients of the server. Each one sends its subscriptions on its
+// own request ring and receives the telemetry on its own stream ring.
+enum telemetry_slot { TELEMETRY_INPUT, TELEMETRY_RECORDER, TELEMETRY_SLOTS };
+
+// Shared memory segment holding all the rings. Each drone has its own ring
+// coming from the server, indexed by its ID.
+struct channel_table {
+    struct spsc_ring rings[CH_COUNT];
+    struct spsc_ring drone_rings[MAX_DRONES];
+    struct spsc_ring telemetry_requests[TELEMETRY_SLOTS];
+    struct spsc_ring telemetry_streams[TELEMETRY_SLOTS];
+};
+
+// Process side handle of a ring: the ring and the eventfd used as doorbell.
+// A received batch is kept here and handed out one frame at a time, so
+// consumers never see MSG_BATCH frames.
+struct channel {
+    struct spsc_ring *ring;
+    int efd;
+    struct msg batch;
+    uint16_t batch_offset;
+};
+
+struct channel_table *channels_create(void);
+struct channel_table *channels_open(void);
+void channels_close(struct channel_table *table);
+void channels_destroy(struct channel_table *table);
+
+void ring_init(struct spsc_ring *ring);
+void channel_attach(struct channel *ch, struct spsc_ring *ring, int efd);
+
+bool channel_try_send(struct channel *ch, uint16_t type, const void *payload,
+                      uint16_t length);
+bool channel_try_send_to(struct channel *ch, uint32_t drone, uint16_t type,
+                         const void *payload, uint16_t length);
+void channel_send(struct channel *ch, uint16_t type, const void *payload,
+                  uint16_t length);
+void channel_send_to(struct channel *ch, uint32_t drone, uint16_t type,
+                     const void *payload, uint16_t length);
+bool channel_try_forward(struct channel *ch, const struct msg *msg);
+void channel_forward(struct channel *ch, const struct msg *msg);
+bool channel_recv(struct channel *ch, struct msg *msg);
+bool channel_empty(struct channel *ch);
+
+bool channel_prepare_wait(struct channel *ch);
+void channel_finish_wait(struct channel *ch, bool signaled);
+bool channel_wait(struct channel *ch, struct timeval *timeout);
+
+#endif // !RING_H
@@ -0,0 +1,39 @@
+#include "routing/routing.h"
+#include "protocol/protocol.h"
+
+// Returns the set of endpoints a frame of the given type coming from an
+// endpoint is delivered to. The server and the single process engine both
+// dispatch their frames with it.
+unsigned int route_frame(enum endpoint from, uint16_t type) {
+    switch (from) {
+        case EP_INPUT:
+            // Terminate all processes when STOP is received, forward force
+            // commands from input to the drone
+            if (type == MSG_STOP)
+                return ROUTE_TO(EP_DRONE) | ROUTE_TO(EP_MAP) |
+                       ROUTE_TO(EP_OBSTACLE) | ROUTE_TO(EP_TARGET);
+            if (type == MSG_FORCE)
+                return ROUTE_TO(EP_DRONE);
+            break;
+
+        case EP_MAP:
+            // New targets are generated by the target process, and a hit
+            // target is removed by the drone
+            if (type == MSG_GENERATE)
+                return ROUTE_TO(EP_TARGET);
+            if (type == MSG_TARGET_HIT)
+                return ROUTE_TO(EP_DRONE);
+            break;
+
+        case EP_TARGET:
+        case EP_OBSTACLE:
+            // New obstacles or targets go to both map and drone
+            if (type == MSG_TARGETS || type == MSG_OBSTACLES)
+                return ROUTE_TO(EP_MAP) | ROUTE_TO(EP_DRONE);
+            break;
+
+        default:
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef ROUTING_H
+#define ROUTING_H
+
+#include <stdint.h>
+
+// Components exchanging frames through the server
+enum endpoint {
+    EP_DRONE,
+    EP_MAP,
+    EP_TARGET,
+    EP_OBSTACLE,
+    EP_INPUT,
+    EP_COUNT
+};
+
+// Bit of an endpoint in a set of destinations
+#define ROUTE_TO(endpoint) (1u << (endpoint))
+
+unsigned int route_frame(enum endpoint from, uint16_t type);
+
+#endif // !ROUTING_H
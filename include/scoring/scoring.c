@@ -0,0 +1,107 @@
+#include "scoring/scoring.h"
+#include "constants.h"
+#include <math.h>
+
+// Score increment for reaching the target of index i, impact_time seconds
+// after the targets were generated.
+int target_score(int i, double impact_time) {
+    // --- Scoring Logic ---
+    // If the target 1 is reached within 30 seconds:
+    // Score increases based on the formula: 30 - time taken
+    // Otherwise, it gives a minimal point increase.
+    int increment;
+    if (i == 0) {
+        increment = 4; // Target 1 gives 4 points
+        if (impact_time < 30) {
+            increment += 30 - (int)ceil(impact_time);
+        }
+    } else {
+        increment = 2; // Other targets give 2 point
+    }
+    return increment;
+}
+
+// Checks if the drone is touching the simulation boundaries, in which case
+// the score is decreased.
+bool is_near_wall(struct pos drone_pos) {
+    return drone_pos.y < 3 || drone_pos.y > SIMULATION_HEIGHT - 3 ||
+           drone_pos.x < 3 || drone_pos.x > SIMULATION_WIDTH - 3;
+}
+
+void scoring_init(struct score_keeper *keeper, double now) {
+    keeper->score        = 0;
+    keeper->targets_time = now;
+    // The first wall contact is always penalized
+    keeper->last_wall_time = -HUGE_VAL;
+    keeper->targets_hit    = 0;
+    keeper->wall_hits      = 0;
+}
+
+// Starts the timer of a new set of targets
+void scoring_new_targets(struct score_keeper *keeper, double now) {
+    keeper->targets_time = now;
+}
+
+// Scores the hit of target i and restarts the timer of the next one. Returns
+// the score increment.
+int scoring_target_hit(struct score_keeper *keeper, int i, double now) {
+    int increment        = target_score(i, now - keeper->targets_time);
+    keeper->targets_time = now;
+    keeper->score += increment;
+    keeper->targets_hit++;
+    return increment;
+}
+
+// Applies the wall penalty if the drone touches a wall and no penalty was
+// given in the last WALL_PENALTY_PERIOD seconds. Returns the score increment.
+int scoring_wall(struct score_keeper *keeper, struct pos drone_pos,
+                 double now) {
+    if (!is_near_wall(drone_pos) ||
+        now - keeper->last_wall_time <= WALL_PENALTY_PERIOD)
+        return 0;
+
+    keeper->last_wall_time = now;
+    keeper->score--;
+    keeper->wall_hits++;
+    return -1;
+}
+
+// Returns the index of the first target reached by a drone moving in a
+// straight line from `from` to `to`, -1 if none is. A target is reached if the
+// segment passes within radius of it, so a fast drone cannot jump over a
+// target between two checks. The first one is the one entered at the smallest
+// fraction of the segment.
+int find_swept_hit(const struct pos *targets, int count, struct pos from,
+                   struct pos to, float radius) {
+    float dx  = to.x - from.x;
+    float dy  = to.y - from.y;
+    float len = dx * dx + dy * dy;
+
+    int first         = -1;
+    float first_entry = HUGE_VALF;
+    for (int i = 0; i < count; i++) {
+        // Solve |from - target + s (to - from)| = radius for the entry s
+        float fx = from.x - targets[i].x;
+        float fy = from.y - targets[i].y;
+        float b  = fx * dx + fy * dy;
+        float c  = fx * fx + fy * fy - radius * radius;
+
+        float entry;
+        if (c <= 0) {
+            entry = 0; // Already within radius at the start
+        } else {
+            float discriminant = b * b - len * c;
+            if (len == 0 || b >= 0 || discriminant < 0)
+                continue; // Still, moving away or passing by
+            entry = (-b - sqrtf(discriminant)) / len;
+            if (entry > 1)
+                continue; // Reached only after the end of the segment
+        }
+
+        if (entry < first_entry) {
+            first       = i;
+            first_entry = entry;
+        }
+    }
+    return first;
+}
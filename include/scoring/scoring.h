@@ -0,0 +1,31 @@
+#ifndef SCORING_H
+#define SCORING_H
+
+#include "droneDataStructs.h"
+#include <stdbool.h>
+
+// Minimum time in seconds between two wall penalties
+#define WALL_PENALTY_PERIOD 3
+
+// Score of a game. Times are in seconds on the clock chosen by the caller, the
+// wall clock for the map and the simulated one for the batch runs.
+struct score_keeper {
+    int score;
+    double targets_time;   // Generation time of the current targets
+    double last_wall_time; // Time of the last wall penalty
+    int targets_hit;
+    int wall_hits;
+};
+
+int target_score(int i, double impact_time);
+bool is_near_wall(struct pos drone_pos);
+
+void scoring_init(struct score_keeper *keeper, double now);
+void scoring_new_targets(struct score_keeper *keeper, double now);
+int scoring_target_hit(struct score_keeper *keeper, int i, double now);
+int scoring_wall(struct score_keeper *keeper, struct pos drone_pos,
+                 double now);
+int find_swept_hit(const struct pos *targets, int count, struct pos from,
+                   struct pos to, float radius);
+
+#endif // !SCORING_H
@@ -0,0 +1,13 @@
+#include "spawn/spawn.h"
+#include <stdlib.h>
+
+// Fills the set with count random positions within the simulation boundaries.
+// The generator state is owned by the caller, so a seed always gives the same
+// sequence of sets.
+void spawn_entities(struct entity_set *set, int count, unsigned int *seed) {
+    set->count = count;
+    for (int i = 0; i < count; i++) {
+        set->items[i].x = rand_r(seed) % SIMULATION_WIDTH;
+        set->items[i].y = rand_r(seed) % SIMULATION_HEIGHT;
+    }
+}
@@ -0,0 +1,8 @@
+#ifndef SPAWN_H
+#define SPAWN_H
+
+#include "protocol/protocol.h"
+
+void spawn_entities(struct entity_set *set, int count, unsigned int *seed);
+
+#endif // !SPAWN_H
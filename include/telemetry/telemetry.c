@@ -0,0 +1,135 @@
+#include "telemetry/telemetry.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <sys/timerfd.h>
+
+void telemetry_init(struct telemetry *telemetry, struct channel *stream,
+                    struct blackboard *bb) {
+    telemetry->stream       = stream;
+    telemetry->bb           = bb;
+    telemetry->tfd          = Timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    telemetry->subscription = (struct subscription){0, 0, DRONE_ALL};
+    telemetry->next_drone   = 0;
+}
+
+// Replaces the subscription of the client. The timer is armed with the new
+// period, or disarmed if no topic is subscribed, and the whole state of the
+// subscribed topics is pushed right away.
+void telemetry_subscribe(struct telemetry *telemetry,
+                         const struct subscription *subscription) {
+    telemetry->subscription = *subscription;
+    if (telemetry->subscription.period_us < TELEMETRY_MIN_PERIOD_US)
+        telemetry->subscription.period_us = TELEMETRY_MIN_PERIOD_US;
+
+    memset(telemetry->drone_sent, 0, sizeof(telemetry->drone_sent));
+    telemetry->targets_sent   = false;
+    telemetry->obstacles_sent = false;
+    telemetry->score_sent     = false;
+    telemetry->next_drone     = 0;
+
+    uint64_t period_ns = 0;
+    if (telemetry->subscription.topics)
+        period_ns = (uint64_t)telemetry->subscription.period_us * 1000;
+    struct timespec period = {period_ns / 1000000000ull,
+                              period_ns % 1000000000ull};
+    struct itimerspec spec = {period, period};
+    Timerfd_settime(telemetry->tfd, 0, &spec, NULL);
+
+    telemetry_publish(telemetry);
+}
+
+// Sends a section if it differs from the copy last pushed, which is then
+// replaced. Returns false if the stream is full: the section is left unsent
+// and compared again at the next period, so a slow client never stalls the
+// server.
+static bool push_changed(struct telemetry *telemetry, bool *sent, void *last,
+                         const void *now, uint16_t size, uint16_t type,
+                         uint32_t drone) {
+    if (*sent && memcmp(last, now, size) == 0)
+        return true;
+    if (!channel_try_send_to(telemetry->stream, drone, type, now, size))
+        return false;
+    memcpy(last, now, size);
+    *sent = true;
+    return true;
+}
+
+// Pushes the subscribed sections of the blackboard that changed. The score
+// and the sets go first, being few and small. The drone states then start
+// from the drone the stream was full at in the previous period, so that
+// every drone is pushed in turn even if the stream never takes them all.
+void telemetry_publish(struct telemetry *telemetry) {
+    struct blackboard *bb = telemetry->bb;
+    uint32_t topics       = telemetry->subscription.topics;
+    uint32_t drone        = telemetry->subscription.drone;
+
+    if (topics & TOPIC_SCORE) {
+        int32_t score;
+        BB_SNAPSHOT(bb, score, &score);
+        if (!push_changed(telemetry, &telemetry->score_sent, &telemetry->score,
+                          &score, sizeof(score), MSG_SCORE, DRONE_ALL))
+            return;
+    }
+
+    if (topics & TOPIC_TARGETS) {
+        struct entity_set targets;
+        BB_SNAPSHOT(bb, targets, &targets);
+        if (!push_changed(telemetry, &telemetry->targets_sent,
+                          &telemetry->targets, &targets,
+                          ENTITY_SET_SIZE(targets.count), MSG_TARGETS,
+                          DRONE_ALL))
+            return;
+    }
+
+    if (topics & TOPIC_OBSTACLES) {
+        struct entity_set obstacles;
+        BB_SNAPSHOT(bb, obstacles, &obstacles);
+        if (!push_changed(telemetry, &telemetry->obstacles_sent,
+                          &telemetry->obstacles, &obstacles,
+                          ENTITY_SET_SIZE(obstacles.count), MSG_OBSTACLES,
+                          DRONE_ALL))
+            return;
+    }
+
+    if (topics & TOPIC_DRONE_STATE) {
+        uint32_t first = 0, count = bb->drone_count;
+        if (drone != DRONE_ALL) {
+            first = drone;
+            count = drone < count ? 1 : 0;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t id = first + (telemetry->next_drone + i) % count;
+            struct drone_state state;
+            BB_SNAPSHOT_DRONE(bb, id, &state);
+            if (!push_changed(telemetry, &telemetry->drone_sent[id],
+                              &telemetry->drones[id], &state, sizeof(state),
+                              MSG_DRONE_STATE, id)) {
+                telemetry->next_drone = id - first;
+                return;
+            }
+        }
+    }
+}
+
+// Called when the timer file descriptor is readable
+void telemetry_expire(struct telemetry *telemetry) {
+    uint64_t expirations;
+    if (read(telemetry->tfd, &expirations, sizeof(expirations)) < 0) {
+        if (errno == EAGAIN)
+            return;
+        char msg[MAX_STR_LEN];
+        sprintf(msg, "Error on reading timerfd %d: %s, pid: %d",
+                telemetry->tfd, strerror(errno), getpid());
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+    telemetry_publish(telemetry);
+}
+
+// Tells a subscribed client that the simulation is over
+void telemetry_stop(struct telemetry *telemetry) {
+    if (telemetry->subscription.topics)
+        channel_try_send(telemetry->stream, MSG_STOP, NULL, 0);
+}
+
+void telemetry_close(struct telemetry *telemetry) { Close(telemetry->tfd); }
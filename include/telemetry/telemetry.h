@@ -0,0 +1,46 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "blackboard/blackboard.h"
+#include "constants.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Publisher of the telemetry of one client. At each period the subscribed
+// sections of the blackboard are read and only those that changed since the
+// last push are sent, one frame each. The last state pushed is kept per topic
+// and per drone to find the changes.
+struct telemetry {
+    struct channel *stream;
+    struct blackboard *bb;
+    int tfd; // Periodic timer, disarmed while there is no subscription
+    struct subscription subscription;
+
+    // Last state pushed, valid only where the matching flag is set. The
+    // flags are cleared by a new subscription, so that its first push sends
+    // everything.
+    struct drone_state drones[MAX_DRONES];
+    struct entity_set targets;
+    struct entity_set obstacles;
+    int32_t score;
+    bool drone_sent[MAX_DRONES];
+    bool targets_sent;
+    bool obstacles_sent;
+    bool score_sent;
+    // Drone the states are pushed from at the next period, relative to the
+    // first one subscribed
+    uint32_t next_drone;
+};
+
+void telemetry_init(struct telemetry *telemetry, struct channel *stream,
+                    struct blackboard *bb);
+void telemetry_subscribe(struct telemetry *telemetry,
+                         const struct subscription *subscription);
+void telemetry_publish(struct telemetry *telemetry);
+void telemetry_expire(struct telemetry *telemetry);
+void telemetry_stop(struct telemetry *telemetry);
+void telemetry_close(struct telemetry *telemetry);
+
+#endif // !TELEMETRY_H
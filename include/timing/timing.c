@@ -0,0 +1,110 @@
+#include "timing/timing.h"
+#include "utility/utility.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NSEC_PER_SEC 1000000000ll
+
+static int64_t timespec_to_ns(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static struct timespec ns_to_timespec(int64_t ns) {
+    struct timespec ts = {ns / NSEC_PER_SEC, ns % NSEC_PER_SEC};
+    return ts;
+}
+
+void fixed_step_init(struct fixed_step *clock, double period_s,
+                     int max_catchup) {
+    clock->period_ns   = (int64_t)(period_s * NSEC_PER_SEC);
+    clock->max_catchup = max_catchup;
+    clock->steps = clock->overruns = clock->dropped = 0;
+
+    // The first step is due one period from now
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    clock->deadline = ns_to_timespec(timespec_to_ns(&now) + clock->period_ns);
+}
+
+// Changes the period starting from the next step
+void fixed_step_set_period(struct fixed_step *clock, double period_s) {
+    int64_t period_ns = (int64_t)(period_s * NSEC_PER_SEC);
+    clock->deadline   = ns_to_timespec(timespec_to_ns(&clock->deadline) -
+                                       clock->period_ns + period_ns);
+    clock->period_ns  = period_ns;
+}
+
+// Sleeps until the absolute deadline. A sleep interrupted by the watchdog
+// signal is simply restarted without any drift.
+static void sleep_until(const struct timespec *deadline) {
+    int ret;
+    while ((ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline,
+                                  NULL)) == EINTR)
+        ;
+    if (ret != 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg, "Error on executing clock_nanosleep: %s, pid: %d",
+                strerror(ret), getpid());
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Moves the deadline one period ahead of a step started late_ns after it,
+// forgetting the steps beyond the catch-up cap
+static void advance(struct fixed_step *clock, int64_t late_ns) {
+    int64_t missed = late_ns / clock->period_ns;
+    if (missed > clock->max_catchup) {
+        clock->dropped += missed - clock->max_catchup;
+        clock->deadline =
+            ns_to_timespec(timespec_to_ns(&clock->deadline) +
+                           (missed - clock->max_catchup) * clock->period_ns);
+    }
+
+    clock->steps++;
+    clock->deadline = ns_to_timespec(timespec_to_ns(&clock->deadline) +
+                                     clock->period_ns);
+}
+
+// Time elapsed since the deadline of the next step, negative before it
+static int64_t lateness(const struct fixed_step *clock) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timespec_to_ns(&now) - timespec_to_ns(&clock->deadline);
+}
+
+// Waits for the deadline of the next step, then moves it one period ahead.
+// Returns immediately if the deadline has already passed.
+void fixed_step_wait(struct fixed_step *clock) {
+    int64_t late = lateness(clock);
+    if (late <= 0) {
+        sleep_until(&clock->deadline);
+        late = 0;
+    } else {
+        clock->overruns++;
+    }
+    advance(clock, late);
+}
+
+// Returns true if the deadline of the next step has passed, and then moves it
+// one period ahead like fixed_step_wait. Never sleeps, and since a polled
+// step always starts a little after its deadline it is not an overrun.
+bool fixed_step_due(struct fixed_step *clock) {
+    int64_t late = lateness(clock);
+    if (late < 0)
+        return false;
+    advance(clock, late);
+    return true;
+}
+
+// Sleeps until the earlier deadline of the two clocks without moving them, so
+// that a loop paced by both then runs the steps fixed_step_due reports
+void fixed_step_sleep_first(const struct fixed_step *a,
+                            const struct fixed_step *b) {
+    const struct fixed_step *first =
+        timespec_to_ns(&a->deadline) <= timespec_to_ns(&b->deadline) ? a : b;
+    if (lateness(first) < 0)
+        sleep_until(&first->deadline);
+}
@@ -0,0 +1,29 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Fixed timestep scheduler. Deadlines are absolute and advance by exactly one
+// period per step, so compute and syscall time do not accumulate as drift. A
+// late loop runs its next steps back to back until it catches up, at most
+// max_catchup steps, then the missed time is dropped.
+struct fixed_step {
+    struct timespec deadline; // Absolute monotonic time of the next step
+    int64_t period_ns;
+    int max_catchup;
+    uint64_t steps;    // Steps run since the start
+    uint64_t overruns; // Steps started after their deadline
+    uint64_t dropped;  // Steps skipped because the catch-up cap was reached
+};
+
+void fixed_step_init(struct fixed_step *clock, double period_s,
+                     int max_catchup);
+void fixed_step_set_period(struct fixed_step *clock, double period_s);
+void fixed_step_wait(struct fixed_step *clock);
+bool fixed_step_due(struct fixed_step *clock);
+void fixed_step_sleep_first(const struct fixed_step *a,
+                            const struct fixed_step *b);
+
+#endif // !TIMING_H
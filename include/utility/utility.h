@@ -3,15 +3,14 @@
 
 #include "constants.h"
 #include "droneDataStructs.h"
+#include "logger/logger.h"
 #include "wrappers/wrappers.h"
-#include <cjson/cJSON.h>
 #include <signal.h>
 
-float get_param(const char *process, const char *param);
 void logging(char *type, char *message);
 int max_of_many(int count, ...);
-void tokenization(struct pos *arr_to_fill, char *to_tokenize, int *objects_num);
 void remove_target(int index, struct pos *objects_arr, int objects_num);
+struct pos drone_start_position(int id, int count);
 void signal_handler(int signo, siginfo_t *info, void *context);
 
 // Macro to handle the watchdog signals for each process
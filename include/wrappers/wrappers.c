@@ -360,4 +360,205 @@ void Fclose(FILE *stream) {
         logging("ERROR", msg);
         exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+}
+
+int Shm_open(const char *name, int oflag, mode_t mode) {
+    int ret = shm_open(name, oflag, mode);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing shm_open: %s, pid: %d, from: %s, line: "
+                "%d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+void Shm_unlink(const char *name) {
+    int ret = shm_unlink(name);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing shm_unlink: %s, pid: %d, from: %s, line: "
+                "%d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int Ftruncate(int fd, off_t length) {
+    int ret = ftruncate(fd, length);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing ftruncate: %s, pid: %d, from: %s, line: "
+                "%d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+void *Mmap(void *addr, size_t length, int prot, int flags, int fd,
+           off_t offset) {
+    void *ret = mmap(addr, length, prot, flags, fd, offset);
+    if (ret == MAP_FAILED) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing mmap: %s, pid: %d, from: %s, line: %d, "
+                "awaiting "
+                "termination "
+                "from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+void Munmap(void *addr, size_t length) {
+    int ret = munmap(addr, length);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing munmap: %s, pid: %d, from: %s, line: %d, "
+                "awaiting "
+                "termination "
+                "from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        exit(EXIT_FAILURE);
+    }
+}
+
+int Eventfd(unsigned int initval, int flags) {
+    int ret = eventfd(initval, flags);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing eventfd: %s, pid: %d, from: %s, line: %d, "
+                "awaiting "
+                "termination "
+                "from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+int Epoll_create1(int flags) {
+    int ret = epoll_create1(flags);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing epoll_create1: %s, pid: %d, from: %s, "
+                "line: %d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+int Epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
+    int ret = epoll_ctl(epfd, op, fd, event);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing epoll_ctl: %s, pid: %d, from: %s, line: "
+                "%d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+int Epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout) {
+    int ret = epoll_wait(epfd, events, maxevents, timeout);
+    // An interruption by a signal is not an error, no event is reported
+    if (ret < 0 && errno == EINTR)
+        return 0;
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing epoll_wait: %s, pid: %d, from: %s, line: "
+                "%d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+int Timerfd_create(int clockid, int flags) {
+    int ret = timerfd_create(clockid, flags);
+    if (ret < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing timerfd_create: %s, pid: %d, from: %s, "
+                "line: %d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+    return ret;
+}
+
+void Timerfd_settime(int fd, int flags, const struct itimerspec *new_value,
+                     struct itimerspec *old_value) {
+    if (timerfd_settime(fd, flags, new_value, old_value) < 0) {
+        char msg[MAX_STR_LEN];
+        sprintf(msg,
+                "Error on executing timerfd_settime: %s, pid: %d, from: %s, "
+                "line: %d, awaiting "
+                "termination from WD",
+                strerror(errno), getpid(), __FILE__, __LINE__);
+        printf("%s\n", msg);
+        fflush(stdout);
+        logging("ERROR", msg);
+        getchar();
+        exit(EXIT_FAILURE);
+    }
+}
@@ -7,8 +7,12 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -34,4 +38,18 @@ void Sigaction(int signum, const struct sigaction *act,
                struct sigaction *oldact);
 void Sigprocmask(int type, const sigset_t *mask, sigset_t *oldset);
 void Fclose(FILE *stream);
+int Shm_open(const char *name, int oflag, mode_t mode);
+void Shm_unlink(const char *name);
+int Ftruncate(int fd, off_t length);
+void *Mmap(void *addr, size_t length, int prot, int flags, int fd,
+           off_t offset);
+void Munmap(void *addr, size_t length);
+int Eventfd(unsigned int initval, int flags);
+int Epoll_create1(int flags);
+int Epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int Epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout);
+int Timerfd_create(int clockid, int flags);
+void Timerfd_settime(int fd, int flags, const struct itimerspec *new_value,
+                     struct itimerspec *old_value);
 #endif // !WRAPPERS_H
@@ -0,0 +1,152 @@
+#include "config/config.h"
+#include "constants.h"
+#include "controls/controls.h"
+#include "droneDataStructs.h"
+#include "engine/engine.h"
+#include "utility/utility.h"
+#include <math.h>
+#include <time.h>
+
+// Default number of episodes, simulated length of an episode in seconds and
+// seed of the first episode
+#define DEFAULT_EPISODES 10
+#define DEFAULT_DURATION 120
+#define DEFAULT_SEED 1
+
+// Score and path statistics of one episode
+struct episode_stats {
+    int score;
+    int targets_hit;
+    int wall_hits;
+    int target_sets; // Sets of targets generated, the first one included
+    double path_length;
+    double mean_speed;
+    double max_speed;
+};
+
+// Key pressed by the autopilot during one input period. It steers the user
+// force toward the force of maximum magnitude pointing at the target, one
+// force step per axis and per key like a player would do.
+static int pilot_key(struct force current, struct pos drone, struct pos target,
+                     const struct input_config *input) {
+    static const char keys[3][3] = {
+        {'q', 'w', 'e'},
+        {'a', '.', 'd'},
+        {'z', 'x', 'c'},
+    };
+    float dx       = target.x - drone.x;
+    float dy       = target.y - drone.y;
+    float distance = sqrtf(dx * dx + dy * dy);
+    if (distance == 0)
+        return 's';
+
+    float diff_x = input->max_force * dx / distance - current.x_component;
+    float diff_y = input->max_force * dy / distance - current.y_component;
+    float half   = input->force_step / 2;
+    int col      = diff_x > half ? 2 : diff_x < -half ? 0 : 1;
+    int row      = diff_y > half ? 2 : diff_y < -half ? 0 : 1;
+    return keys[row][col];
+}
+
+// Plays one episode in the single process engine, on its simulated clock
+static void run_episode(const struct drone_config *params,
+                        const struct input_config *input, double duration,
+                        unsigned int seed, struct episode_stats *stats) {
+    static struct engine engine;
+    engine_init(&engine, params, seed);
+    memset(stats, 0, sizeof(*stats));
+
+    // Period of the input, in steps of the simulated clock
+    double T           = params->time_step;
+    long steps         = (long)(duration / T);
+    long input_period  = fmax(round(INPUT_PERIOD / T), 1);
+    double speed_total = 0;
+
+    // Force commanded by the autopilot, sent like the input process does
+    struct force drone_force = {0, 0};
+
+    for (long step = 0; step < steps; step++) {
+        // Input: one key per input period
+        if (step % input_period == 0 && engine.target_num > 0) {
+            int key = pilot_key(drone_force, engine.body.position,
+                                engine.targets_pos[0], input);
+            if (update_force(&drone_force, key, input->force_step,
+                             input->max_force))
+                engine_send(&engine, EP_INPUT, MSG_FORCE, &drone_force,
+                            sizeof(drone_force));
+        }
+
+        struct pos before = engine.body.position;
+        engine_step(&engine);
+
+        // Path and speed statistics
+        float speed = hypotf(engine.body.velocity.x_component,
+                             engine.body.velocity.y_component);
+        stats->path_length += hypot(engine.body.position.x - before.x,
+                                    engine.body.position.y - before.y);
+        speed_total += speed;
+        if (speed > stats->max_speed)
+            stats->max_speed = speed;
+    }
+
+    stats->score       = engine.keeper.score;
+    stats->targets_hit = engine.keeper.targets_hit;
+    stats->wall_hits   = engine.keeper.wall_hits;
+    stats->target_sets = engine.target_sets;
+    stats->mean_speed  = steps > 0 ? speed_total / steps : 0;
+}
+
+// Runs episodes of the game faster than real time, to evaluate a set of
+// parameters of drone_parameters.json. Each episode is seeded with its own
+// seed, so a run is reproducible. One CSV line is printed per episode.
+int main(int argc, char *argv[]) {
+    int episodes      = DEFAULT_EPISODES;
+    double duration   = DEFAULT_DURATION;
+    unsigned int seed = DEFAULT_SEED;
+    if (argc > 4 || (argc > 1 && sscanf(argv[1], "%d", &episodes) != 1) ||
+        (argc > 2 && sscanf(argv[2], "%lf", &duration) != 1) ||
+        (argc > 3 && sscanf(argv[3], "%u", &seed) != 1)) {
+        printf("Usage: %s [episodes [duration_s [seed]]]\n", argv[0]);
+        exit(1);
+    }
+
+    struct drone_config params = {0};
+    struct input_config input  = {0};
+    if (!config_load_drone(&params) || !config_load_input(&input)) {
+        printf("Batch: Error - Invalid config file\n");
+        exit(1);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    printf("episode,seed,score,targets_hit,wall_hits,target_sets,"
+           "path_length,mean_speed,max_speed\n");
+    double score_total = 0;
+    for (int episode = 0; episode < episodes; episode++) {
+        struct episode_stats stats;
+        run_episode(&params, &input, duration, seed + episode, &stats);
+        printf("%d,%u,%d,%d,%d,%d,%.2f,%.2f,%.2f\n", episode, seed + episode,
+               stats.score, stats.targets_hit, stats.wall_hits,
+               stats.target_sets, stats.path_length, stats.mean_speed,
+               stats.max_speed);
+        score_total += stats.score;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) +
+                     (end.tv_nsec - start.tv_nsec) / 1e9;
+    double simulated = episodes * duration;
+
+    char aux[200];
+    sprintf(aux,
+            "Batch: %d episodes, %.0f s simulated in %.3f s (%.0fx real "
+            "time), mean score %.2f",
+            episodes, simulated, elapsed,
+            elapsed > 0 ? simulated / elapsed : 0,
+            episodes > 0 ? score_total / episodes : 0);
+    fprintf(stderr, "%s\n", aux);
+    logging("INFO", aux);
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "blackboard/blackboard.h"
+#include "config/config.h"
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "fleet/fleet.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "timing/timing.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <math.h>
+#include <unistd.h>
+
+// Publishes the state of a drone in its own slot of the blackboard. Each slot
+// has its own seqlock, so the workers publish concurrently.
+static void publish_drone(void *context, int id,
+                          const struct drone_body *body) {
+    struct blackboard *bb    = context;
+    struct drone_state state = {body->position, body->velocity};
+    BB_PUBLISH_DRONE(bb, id, &state);
+}
+
+// Applies a frame coming from the server. The world frames are sent to every
+// drone, so they are applied once, from the ring of drone 0. Returns true on
+// STOP.
+static bool apply_frame(struct fleet *fleet, struct world_snapshot *world,
+                        const struct drone_config *params, int id,
+                        const struct msg *received) {
+    switch (received->header.type) {
+        case MSG_STOP:
+            return true;
+
+        case MSG_FORCE:
+            fleet->forces[id] = received->payload.force;
+            break;
+
+        case MSG_TARGET_HIT:
+            if (id == 0 && !world_remove_target(world,
+                                                received->payload.hit.index,
+                                                received->payload.hit.position))
+                logging("ERROR", "Mismatched target and array in fleet");
+            break;
+
+        case MSG_TARGETS:
+            if (id == 0) {
+                world_set_targets(world, received->payload.set.items,
+                                  received->payload.set.count, params);
+                logging("INFO", "Fleet received new target data");
+            }
+            break;
+
+        case MSG_OBSTACLES:
+            if (id == 0) {
+                world_set_obstacles(world, received->payload.set.items,
+                                    received->payload.set.count, params);
+                logging("INFO", "Fleet received new obstacle data");
+            }
+            break;
+    }
+    return false;
+}
+
+// Steps every drone in a single process, on a pool of threads, instead of one
+// drone process per vehicle. The server and the other processes see the same
+// rings and blackboard slots as with the drone processes.
+int main(int argc, char *argv[]) {
+    // Handle watchdog signals to monitor the process
+    HANDLE_WATCHDOG_SIGNALS();
+
+    // Map the blackboard where the drone states are published
+    struct blackboard *bb = blackboard_open();
+
+    // Validate command-line arguments: the doorbell of the ring coming from
+    // the server of each drone, in order of ID
+    int count = argc - 1;
+    if (count < 1 || count != bb->drone_count) {
+        printf("Wrong number of arguments in fleet\n");
+        getchar();
+        exit(1);
+    }
+    int from_server_efd[MAX_DRONES];
+    for (int id = 0; id < count; id++)
+        sscanf(argv[id + 1], "%d", &from_server_efd[id]);
+
+    // Retrieve Parameters from Config File, then again only when it is
+    // modified
+    struct drone_config params = {0};
+    if (!config_load_drone(&params)) {
+        printf("Fleet: Error - Invalid config file\n");
+        getchar();
+        exit(1);
+    }
+    struct config_watch config_watch;
+    config_watch_init(&config_watch);
+
+    // Simulation time step and update frequency of the parameters, as in
+    // drone.c
+    float T                     = params.time_step;
+    int reading_params_interval = round(params.reading_params_interval / T);
+    if (reading_params_interval < 1)
+        reading_params_interval = 1;
+
+    // Attach to the rings coming from the server, polled at every step
+    struct channel_table *channels = channels_open();
+    static struct channel from_server[MAX_DRONES];
+    for (int id = 0; id < count; id++)
+        channel_attach(&from_server[id], &channels->drone_rings[id],
+                       from_server_efd[id]);
+
+    // Obstacles and targets shared by all the drones, modified only between
+    // two ticks
+    static struct world_snapshot world;
+    world_init(&world, &params);
+
+    // Walls and obstacles rasterized in the background, if static_field is
+    // set, and shared by all the drones
+    static struct potential_builder potential;
+    potential_init(&potential);
+    unsigned long requested_version = world.obstacles_version - 1;
+
+    // One thread per core, but no more than chunks of drones
+    static struct fleet fleet;
+    long cores  = sysconf(_SC_NPROCESSORS_ONLN);
+    int chunks  = (count + FLEET_CHUNK - 1) / FLEET_CHUNK;
+    int threads = cores < chunks ? cores : chunks;
+    fleet_init(&fleet, count, threads);
+    fleet.publish = publish_drone;
+    fleet.context = bb;
+
+    char aux[100];
+    sprintf(aux, "Fleet stepping %d drones on %d threads", count,
+            fleet.threads);
+    logging("INFO", aux);
+
+    bool to_exit = false;
+
+    // Steps are scheduled on absolute deadlines T apart, as in drone.c
+    struct fixed_step clock;
+    fixed_step_init(&clock, T, MAX_CATCHUP_STEPS);
+    uint64_t reported_overruns = 0;
+
+    while (!to_exit) {
+        // Check if it's time to look for changes of the configuration file
+        if (!reading_params_interval--) {
+            // The workers are waiting on the barrier, so the new parameters
+            // and the grids can be changed
+            if (config_changed(&config_watch) && config_load_drone(&params)) {
+                T = params.time_step;
+                fixed_step_set_period(&clock, T);
+                world_reindex(&world, &params);
+                logging("INFO", "Fleet has updated its parameters");
+            }
+
+            reading_params_interval = round(params.reading_params_interval / T);
+            if (reading_params_interval < 1)
+                reading_params_interval = 1;
+
+            if (clock.overruns != reported_overruns) {
+                sprintf(aux,
+                        "Fleet overruns: %llu late steps, %llu dropped out of "
+                        "%llu",
+                        (unsigned long long)clock.overruns,
+                        (unsigned long long)clock.dropped,
+                        (unsigned long long)clock.steps);
+                logging("WARN", aux);
+                reported_overruns = clock.overruns;
+            }
+        }
+
+        // Process every frame queued by the server since the previous tick
+        struct msg received;
+        for (int id = 0; id < count && !to_exit; id++)
+            while (!to_exit && channel_recv(&from_server[id], &received))
+                to_exit = apply_frame(&fleet, &world, &params, id, &received);
+        if (to_exit)
+            break;
+
+        // A new set of obstacles, or new parameters, is rasterized again. The
+        // drones evaluate the obstacles until the field is ready.
+        if (world.obstacles_version != requested_version) {
+            potential_request(&potential, &world.obstacles, &params);
+            requested_version = world.obstacles_version;
+        }
+        world.potential = potential_current(&potential);
+
+        // Advance all the drones by one step, they are published by the
+        // workers as soon as they are stepped
+        fleet_step(&fleet, &world, &params);
+
+        // Wait for the deadline of the next step
+        fixed_step_wait(&clock);
+    }
+
+    // Cleanup: join the workers, unmap the rings and the blackboard
+    fleet_destroy(&fleet);
+    potential_destroy(&potential);
+    config_watch_close(&config_watch);
+    for (int id = 0; id < count; id++)
+        Close(from_server_efd[id]);
+    channels_close(channels);
+    blackboard_close(bb);
+    return 0;
+}
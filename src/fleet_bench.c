@@ -0,0 +1,94 @@
+#include "config/config.h"
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "fleet/fleet.h"
+#include "spawn/spawn.h"
+#include "utility/utility.h"
+#include <time.h>
+#include <unistd.h>
+
+// Default number of drones and of ticks of each run
+#define BENCH_DRONES 512
+#define BENCH_TICKS 2000
+
+// Returns the monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Steps the fleet on the given number of threads, every drone pushed by its
+// own constant force through the same obstacles and targets. Returns the
+// elapsed time.
+static double bench_fleet(int drones, long ticks, int threads,
+                          const struct world_snapshot *world,
+                          const struct drone_config *params) {
+    static struct fleet fleet;
+    fleet_init(&fleet, drones, threads);
+    for (int id = 0; id < drones; id++) {
+        fleet.forces[id].x_component = id % 7 - 3;
+        fleet.forces[id].y_component = id % 5 - 2;
+    }
+
+    double start = now();
+    for (long tick = 0; tick < ticks; tick++)
+        fleet_step(&fleet, world, params);
+    double elapsed = now() - start;
+    fleet_destroy(&fleet);
+    return elapsed;
+}
+
+// Measures how the fleet scales with the number of threads, from one up to
+// the number of cores or the given maximum
+int main(int argc, char *argv[]) {
+    int drones  = BENCH_DRONES;
+    long ticks  = BENCH_TICKS;
+    int threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 4 || (argc > 1 && sscanf(argv[1], "%d", &drones) != 1) ||
+        (argc > 2 && sscanf(argv[2], "%ld", &ticks) != 1) ||
+        (argc > 3 && sscanf(argv[3], "%d", &threads) != 1) || drones < 1 ||
+        drones > FLEET_MAX_DRONES) {
+        printf("Usage: %s [drones [ticks [threads]]], drones from 1 to %d\n",
+               argv[0], FLEET_MAX_DRONES);
+        exit(1);
+    }
+
+    struct drone_config params = {0};
+    if (!config_load_drone(&params)) {
+        printf("Fleet bench: Error - Invalid config file\n");
+        exit(1);
+    }
+
+    // Same world for every run
+    static struct world_snapshot world;
+    struct entity_set set;
+    unsigned int seed = 1;
+    world_init(&world, &params);
+    spawn_entities(&set, N_OBSTACLES, &seed);
+    world_set_obstacles(&world, set.items, set.count, &params);
+    spawn_entities(&set, N_TARGETS, &seed);
+    world_set_targets(&world, set.items, set.count, &params);
+
+    // The obstacles never change, so the static field is built once
+    static struct potential_field potential;
+    if (params.static_field) {
+        potential_build(&potential, &world.obstacles, &params);
+        world.potential = &potential;
+    }
+
+    printf("Drones: %d, ticks per run: %ld\n", drones, ticks);
+    printf("Threads   drone steps/s   speedup\n");
+    double single = 0;
+    // Doubling the threads, the last run uses all of them
+    for (int t = 1;; t = t * 2 < threads ? t * 2 : threads) {
+        double elapsed = bench_fleet(drones, ticks, t, &world, &params);
+        if (t == 1)
+            single = elapsed;
+        printf("%7d %15.0f %8.2fx\n", t, drones * ticks / elapsed,
+               single / elapsed);
+        if (t >= threads)
+            break;
+    }
+    return EXIT_SUCCESS;
+}
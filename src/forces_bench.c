@@ -0,0 +1,141 @@
+#include "config/config.h"
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "forces/forces.h"
+#include "grid/grid.h"
+#include "physics/physics.h"
+#include "spawn/spawn.h"
+#include "utility/utility.h"
+#include <math.h>
+#include <time.h>
+
+// Default number of force evaluations of each run
+#define BENCH_QUERIES 20000
+// Drone positions cycled through by the queries
+#define BENCH_POSITIONS 1024
+// Largest set given to the kernel, well beyond the MAX_ENTITIES of a store
+#define BENCH_MAX_COUNT 4096
+
+// Keeps the compiler from dropping the evaluations
+static volatile float sink;
+
+// Returns the monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Sums the obstacle forces entity by entity with atan2/cos/sin in double, as
+// the drone did before the SoA kernel, for a unit speed and scale
+static struct force reference_force(const float *x, const float *y, int count,
+                                    float px, float py, float area_of_effect) {
+    struct force total = {0, 0};
+    for (int i = 0; i < count; i++) {
+        float x_dist   = x[i] - px;
+        float y_dist   = y[i] - py;
+        float distance = sqrt(pow(x_dist, 2) + pow(y_dist, 2));
+        if (distance < area_of_effect && distance > 1) {
+            double magnitude =
+                -compute_repulsive_force(distance, 1, area_of_effect, 1, 0);
+            double angle = atan2(y_dist, x_dist);
+            total.x_component += cos(angle) * magnitude;
+            total.y_component += sin(angle) * magnitude;
+        }
+    }
+    return total;
+}
+
+// Ways of summing the force of a set of entities
+enum bench_method { BENCH_REFERENCE, BENCH_KERNEL, BENCH_GRID };
+
+// Evaluates the force of the entities at every query position with the given
+// method. Returns the nanoseconds per evaluation.
+static double bench_run(enum bench_method method, const float *x,
+                        const float *y, int count,
+                        const struct spatial_grid *grid,
+                        const struct pos *positions, long queries,
+                        float area_of_effect) {
+    float sum    = 0;
+    double start = now();
+    for (long q = 0; q < queries; q++) {
+        struct pos p = positions[q % BENCH_POSITIONS];
+        struct force f;
+        switch (method) {
+        case BENCH_REFERENCE:
+            f = reference_force(x, y, count, p.x, p.y, area_of_effect);
+            break;
+        case BENCH_KERNEL:
+            f = field_force(x, y, count, p.x, p.y, 1, area_of_effect);
+            break;
+        case BENCH_GRID:
+            f = grid_field_force(grid, p.x, p.y, 1, area_of_effect, NULL);
+            break;
+        }
+        sum += f.x_component + f.y_component;
+    }
+    double elapsed = now() - start;
+    sink           = sum;
+    return elapsed * 1e9 / queries;
+}
+
+// Measures the obstacle force kernel against the per-entity formula it
+// replaced, from the obstacles of a game to sets of thousands, then the grid
+// against the kernel on the obstacles of a game
+int main(int argc, char *argv[]) {
+    long queries = BENCH_QUERIES;
+    if (argc > 2 || (argc > 1 && sscanf(argv[1], "%ld", &queries) != 1) ||
+        queries < 1) {
+        printf("Usage: %s [queries]\n", argv[0]);
+        exit(1);
+    }
+
+    struct drone_config params = {0};
+    if (!config_load_drone(&params)) {
+        printf("Forces bench: Error - Invalid config file\n");
+        exit(1);
+    }
+    float area_of_effect = params.obst_of_effect;
+
+    unsigned int seed = 1;
+    static struct pos positions[BENCH_POSITIONS];
+    for (int i = 0; i < BENCH_POSITIONS; i++) {
+        positions[i].x = (float)rand_r(&seed) / RAND_MAX * SIMULATION_WIDTH;
+        positions[i].y = (float)rand_r(&seed) / RAND_MAX * SIMULATION_HEIGHT;
+    }
+    alignas(32) static float x[BENCH_MAX_COUNT];
+    alignas(32) static float y[BENCH_MAX_COUNT];
+    for (int i = 0; i < BENCH_MAX_COUNT; i++) {
+        x[i] = rand_r(&seed) % SIMULATION_WIDTH;
+        y[i] = rand_r(&seed) % SIMULATION_HEIGHT;
+    }
+
+    printf("Evaluations per run: %ld, obst_of_effect: %.1f\n", queries,
+           area_of_effect);
+    printf("Entities   atan2 ns   kernel ns   speedup\n");
+    for (int count = N_OBSTACLES; count <= BENCH_MAX_COUNT;
+         count = count < 16 ? 16 : count * 4) {
+        double reference = bench_run(BENCH_REFERENCE, x, y, count, NULL,
+                                     positions, queries, area_of_effect);
+        double kernel    = bench_run(BENCH_KERNEL, x, y, count, NULL,
+                                     positions, queries, area_of_effect);
+        printf("%8d %10.1f %11.1f %8.2fx\n", count, reference, kernel,
+               reference / kernel);
+    }
+
+    // The obstacles of a game, as received by the drone
+    struct entity_set set;
+    static struct entity_store store;
+    static struct spatial_grid grid;
+    spawn_entities(&set, N_OBSTACLES, &seed);
+    store_load(&store, set.items, set.count);
+    grid_build(&grid, &store, area_of_effect);
+    double kernel = bench_run(BENCH_KERNEL, store.x, store.y, store.count,
+                              NULL, positions, queries, area_of_effect);
+    double cells  = bench_run(BENCH_GRID, NULL, NULL, 0, &grid, positions,
+                              queries, area_of_effect);
+    printf("Entities   kernel ns     grid ns   speedup\n");
+    printf("%8d %11.1f %11.1f %8.2fx\n", store.count, kernel, cells,
+           kernel / cells);
+    return EXIT_SUCCESS;
+}
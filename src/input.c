@@ -1,8 +1,57 @@
+#include "blackboard/blackboard.h"
+#include "config/config.h"
+#include "controls/controls.h"
 #include "constants.h"
 #include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include "reactor/reactor.h"
+#include "ring/ring.h"
 #include "utility/utility.h"
 #include "wrappers/wrappers.h"
 #include <math.h>
+#include <sys/timerfd.h>
+
+// Windows of the input display. They are kept between two redraws and built
+// again only when the terminal is resized.
+struct input_display {
+    WINDOW *control; // Left split, with the matrix of the keys
+    WINDOW *info;    // Right split, with the dynamics
+    WINDOW *tl_win, *tc_win, *tr_win;
+    WINDOW *cl_win, *cc_win, *cr_win;
+    WINDOW *bl_win, *bc_win, *br_win;
+};
+
+// State of the input process, shared by the handlers of the event loop
+struct input_state {
+    struct input_display display;
+    int timer_fd; // Fires every input period
+
+    struct input_config params;
+    struct config_watch config_watch;
+    int reading_params_interval; // Input periods before the next check
+
+    // Forces go to the server, the telemetry of the selected drone and the
+    // score come from the telemetry slot of the input
+    struct blackboard *bb;
+    struct channel to_server;
+    struct channel telemetry_requests;
+    struct channel telemetry;
+
+    // Drone controlled by the keys, the force of the others is kept while
+    // another one is selected
+    int selected;
+    struct force drone_force;
+    struct force drone_forces[MAX_DRONES];
+
+    // Telemetry shown on the dynamics display
+    struct drone_state shown_state;
+    int shown_score;
+
+    // Key highlighted in the matrix, and input periods before the highlight
+    // is removed
+    int highlighted;
+    int highlight_periods;
+};
 
 // Creates a window with a border
 // Parameters: height, width, starty (y position), startx (x position)
@@ -12,14 +61,6 @@ WINDOW *input_display_setup(int height, int width, int starty, int startx) {
     return local_win;
 }
 
-// Destroys a window and clears its border.
-// Useful for refreshing or resizing the display.
-void destroy_input_display(WINDOW *local_win) {
-    wborder(local_win, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '); 
-    wrefresh(local_win);  
-    delwin(local_win);    
-}
-
 // Highlights the corresponding window in green when the respective key is pressed.
 void begin_format_input(int input, WINDOW *tl_win, WINDOW *tc_win,
                         WINDOW *tr_win, WINDOW *cl_win, WINDOW *cc_win,
@@ -57,79 +98,291 @@ void end_format_input(int input, WINDOW *tl_win, WINDOW *tc_win, WINDOW *tr_win,
     }
 }
 
-// Calculates the diagonal length of a square given its side length.
-// Uses a precomputed value for sqrt(2)/2 (0.7071) to optimize performance.
-float diag(float side) {
-    const float sqrt2_half = 0.7071; // Precomputed value for sqrt(2)/2
-    return side * sqrt2_half;
+// Builds the windows of the display for the current terminal size
+static void display_build(struct input_display *d) {
+    // Initialize left and right display splits
+    d->control = input_display_setup(LINES, COLS / 2 - 1, 0, 0);
+    d->info    = input_display_setup(LINES, COLS / 2 - 1, 0, COLS / 2);
+
+    // Initialize arrow key display windows in a 3x3 grid
+    d->tl_win = input_display_setup(5, 7, LINES / 4, COLS / 6);
+    d->tc_win = input_display_setup(5, 7, LINES / 4, COLS / 6 + 6);
+    d->tr_win = input_display_setup(5, 7, LINES / 4, COLS / 6 + 12);
+    d->cl_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6);
+    d->cc_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6 + 6);
+    d->cr_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6 + 12);
+    d->bl_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6);
+    d->bc_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6 + 6);
+    d->br_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6 + 12);
+
+    // Set titles for display sections
+    mvwprintw(d->control, 0, 1, "INPUT DISPLAY");
+    mvwprintw(d->info, 0, 1, "DYNAMICS DISPLAY");
 }
 
-// Reduces the force to zero, effectively stopping movement.
-float slow_down(void) {
-    return 0.0f;
+static void display_destroy(struct input_display *d) {
+    WINDOW *windows[] = {d->control, d->info,   d->tl_win, d->tc_win,
+                         d->tr_win,  d->cl_win, d->cc_win, d->cr_win,
+                         d->bl_win,  d->bc_win, d->br_win};
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++)
+        delwin(windows[i]);
 }
 
-// Updates the force applied to the drone based on user input.
-// Returns true if the input is recognized, false otherwise.
-bool update_force(struct force *to_update, int input, float step, float max_force) {
-    /*
-     * Coordinate system:
-     *                     X
-     *           +--------->
-     *           |
-     *           |
-     *         Y |
-     *           V
-     */
-    bool ret = true;
-
-    // Adjust force based on the input key
-    switch (input) {
-        case 'q': // Top-left diagonal
-            to_update->x_component -= diag(step);
-            to_update->y_component -= diag(step);
-            break;
-        case 'w': // Up
-            to_update->y_component -= step;
-            break;
-        case 'e': // Top-right diagonal
-            to_update->x_component += diag(step);
-            to_update->y_component -= diag(step);
-            break;
-        case 'a': // Left
-            to_update->x_component -= step;
-            break;
-        case 's': // Stop (reset force)
-        case ' ':
-            to_update->x_component = slow_down();
-            to_update->y_component = slow_down();
-            break;
-        case 'd': // Right
-            to_update->x_component += step;
-            break;
-        case 'z': // Bottom-left diagonal
-            to_update->x_component -= diag(step);
-            to_update->y_component += diag(step);
-            break;
-        case 'x': // Down
-            to_update->y_component += step;
-            break;
-        case 'c': // Bottom-right diagonal
-            to_update->x_component += diag(step);
-            to_update->y_component += diag(step);
-            break;
-        default: // Invalid input
-            ret = false;
-            break;
+// Draws the matrix of the keys, with the highlighted key in green
+static void draw_controls(struct input_state *state) {
+    struct input_display *d = &state->display;
+    int input               = state->highlighted;
+
+    // Highlight the pressed key
+    begin_format_input(input, d->tl_win, d->tc_win, d->tr_win, d->cl_win,
+                       d->cc_win, d->cr_win, d->bl_win, d->bc_win, d->br_win);
+
+    /// Drawing ASCII arrows
+    // Upward arrows
+    mvwprintw(d->tl_win, 1, 3, "_"); // Top-left
+    mvwprintw(d->tl_win, 2, 2, "'\\");
+    mvwprintw(d->tc_win, 1, 3, "A"); // Top-center
+    mvwprintw(d->tc_win, 2, 3, "|");
+    mvwprintw(d->tr_win, 1, 3, "_"); // Top-right
+    mvwprintw(d->tr_win, 2, 3, "/'");
+
+    // Left and right arrows
+    mvwprintw(d->cl_win, 2, 2, "<"); // Left
+    mvwprintw(d->cl_win, 2, 3, "-");
+    mvwprintw(d->cr_win, 2, 3, "-"); // Right
+    mvwprintw(d->cr_win, 2, 4, ">");
+
+    // Downward arrows
+    mvwprintw(d->bl_win, 2, 2, "|/"); // Bottom-left
+    mvwprintw(d->bl_win, 3, 2, "'-");
+    mvwprintw(d->bc_win, 2, 3, "|"); // Bottom-center
+    mvwprintw(d->bc_win, 3, 3, "V");
+    mvwprintw(d->br_win, 2, 3, "\\|"); // Bottom-right
+    mvwprintw(d->br_win, 3, 3, "-'");
+
+    // Stop symbol (brake)
+    mvwprintw(d->cc_win, 2, 3, "X");
+
+    // Reset color for the next redraw
+    end_format_input(input, d->tl_win, d->tc_win, d->tr_win, d->cl_win,
+                     d->cc_win, d->cr_win, d->bl_win, d->bc_win, d->br_win);
+
+    /// Setting corner symbols in the matrix
+    mvwprintw(d->tc_win, 0, 0, "."); // Top border corners
+    mvwprintw(d->tr_win, 0, 0, ".");
+    mvwprintw(d->cl_win, 0, 0, "+"); // Middle section corners
+    mvwprintw(d->cc_win, 0, 0, "+");
+    mvwprintw(d->cr_win, 0, 0, "+");
+    mvwprintw(d->cr_win, 0, 6, "+");
+    mvwprintw(d->bl_win, 0, 0, "+"); // Bottom border corners
+    mvwprintw(d->bc_win, 0, 0, "+");
+    mvwprintw(d->br_win, 0, 0, "+");
+    mvwprintw(d->br_win, 0, 6, "+");
+    mvwprintw(d->bc_win, 4, 0, "'"); // Bottom edge symbols
+    mvwprintw(d->br_win, 4, 0, "'");
+
+    // Display instruction to exit
+    mvwprintw(d->control, LINES - 3, 3, "Press 'p' to exit");
+    if (state->bb->drone_count > 1)
+        mvwprintw(d->control, LINES - 4, 3,
+                  "Press 'n' to control the next drone");
+
+    // The split goes first, the matrix is drawn over it
+    WINDOW *windows[] = {d->control, d->tl_win, d->tc_win, d->tr_win,
+                         d->cl_win,  d->cc_win, d->cr_win, d->bl_win,
+                         d->bc_win,  d->br_win};
+    for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++)
+        wnoutrefresh(windows[i]);
+}
+
+// Draws the dynamics of the selected drone, its force and the score
+static void draw_dynamics(struct input_state *state) {
+    WINDOW *info                   = state->display.info;
+    struct pos drone_position      = state->shown_state.position;
+    struct velocity drone_velocity = state->shown_state.velocity;
+    struct force drone_force       = state->drone_force;
+
+    // Display the controlled drone
+    mvwprintw(info, LINES / 10, COLS / 10, "Drone %d of %d",
+              state->selected + 1, state->bb->drone_count);
+
+    // Display drone position
+    mvwprintw(info, LINES / 10 + 2, COLS / 10, "Position {");
+    mvwprintw(info, LINES / 10 + 3, COLS / 10, "\tx: %f", drone_position.x);
+    mvwprintw(info, LINES / 10 + 4, COLS / 10, "\ty: %f", drone_position.y);
+    mvwprintw(info, LINES / 10 + 5, COLS / 10, "}");
+
+    // Display drone velocity
+    mvwprintw(info, LINES / 10 + 7, COLS / 10, "Velocity {");
+    mvwprintw(info, LINES / 10 + 8, COLS / 10, "\tx: %f",
+              drone_velocity.x_component);
+    mvwprintw(info, LINES / 10 + 9, COLS / 10, "\ty: %f",
+              drone_velocity.y_component);
+    mvwprintw(info, LINES / 10 + 10, COLS / 10, "}");
+
+    // Display the force currently applied by the user on the drone.
+    // External effects (e.g., borders) are not considered in these values.
+    mvwprintw(info, LINES / 10 + 12, COLS / 10, "Force {");
+
+    // Highlight force values in red if they reach the maximum limit
+    if (fabs(drone_force.x_component) == state->params.max_force)
+        wattron(info, COLOR_PAIR(2));
+    mvwprintw(info, LINES / 10 + 13, COLS / 10, "\tx: %f",
+              drone_force.x_component);
+    wattroff(info, COLOR_PAIR(2));
+
+    if (fabs(drone_force.y_component) == state->params.max_force)
+        wattron(info, COLOR_PAIR(2));
+    mvwprintw(info, LINES / 10 + 14, COLS / 10, "\ty: %f",
+              drone_force.y_component);
+    wattroff(info, COLOR_PAIR(2));
+
+    // Display the current score computed by the map
+    mvwprintw(info, LINES / 10 + 17, COLS / 10, "Score: %d",
+              state->shown_score);
+
+    wnoutrefresh(info);
+}
+
+// Asks the server for the state of the selected drone and the score. The
+// previous subscription is replaced, and the current state is pushed at once.
+static void subscribe(struct input_state *state) {
+    struct subscription subscription = {TOPIC_DRONE_STATE | TOPIC_SCORE,
+                                        INPUT_TELEMETRY_PERIOD_US,
+                                        state->selected};
+    channel_send(&state->telemetry_requests, MSG_SUBSCRIBE, &subscription,
+                 sizeof(subscription));
+}
+
+// Builds the display again after a resize and draws all of it
+static void redraw_all(struct input_state *state) {
+    display_destroy(&state->display);
+    clear();
+    wnoutrefresh(stdscr);
+    display_build(&state->display);
+    draw_controls(state);
+    draw_dynamics(state);
+    doupdate();
+}
+
+// Handles one key. The force is sent to the server at once, and only the
+// parts of the display affected by the key are drawn again.
+static void handle_key(struct reactor *reactor, struct input_state *state,
+                       int input) {
+    // If 'p' is pressed, signal termination to the server and exit
+    if (input == 'p') {
+        channel_send(&state->to_server, MSG_STOP, NULL, 0);
+        reactor_stop(reactor);
+        return;
+    }
+
+    if (input == KEY_RESIZE) {
+        redraw_all(state);
+        return;
+    }
+
+    // Switch to the next drone, resuming the force it was given
+    bool to_draw = false;
+    if (input == 'n') {
+        state->drone_forces[state->selected] = state->drone_force;
+        state->selected    = (state->selected + 1) % state->bb->drone_count;
+        state->drone_force = state->drone_forces[state->selected];
+        subscribe(state);
+        to_draw = true;
+    }
+
+    // Compute the drone's force based on user input, and send it to the
+    // server if it was updated
+    if (update_force(&state->drone_force, input, state->params.force_step,
+                     state->params.max_force)) {
+        channel_send_to(&state->to_server, state->selected, MSG_FORCE,
+                        &state->drone_force, sizeof(state->drone_force));
+        logging("INFO", "Sent updated input force to the server");
+        to_draw = true;
+    }
+
+    // The pressed key stays highlighted for at least one input period
+    state->highlighted       = input;
+    state->highlight_periods = 2;
+    draw_controls(state);
+    if (to_draw)
+        draw_dynamics(state);
+    doupdate();
+}
+
+// stdin is readable: every key typed since the last event is handled
+static void on_keys(struct reactor *reactor, void *context, bool signaled) {
+    (void)signaled;
+    struct input_state *state = context;
+    int input;
+    while (reactor->running && (input = getch()) != ERR)
+        handle_key(reactor, state, input);
+}
+
+// Telemetry pushed by the server: it only holds what changed, so the
+// dynamics are drawn again only when the selected drone or the score changed
+static bool prepare_telemetry(void *context) {
+    struct input_state *state = context;
+    return channel_prepare_wait(&state->telemetry);
+}
+
+static void on_telemetry(struct reactor *reactor, void *context,
+                         bool signaled) {
+    struct input_state *state = context;
+    struct msg received;
+    bool to_draw = false;
+
+    channel_finish_wait(&state->telemetry, signaled);
+    while (reactor->running && channel_recv(&state->telemetry, &received)) {
+        // States of the drone selected before a switch may still arrive
+        if (received.header.type == MSG_DRONE_STATE &&
+            received.header.drone == (uint32_t)state->selected) {
+            state->shown_state = received.payload.state;
+            to_draw            = true;
+        } else if (received.header.type == MSG_SCORE) {
+            state->shown_score = received.payload.score;
+            to_draw            = true;
+        } else if (received.header.type == MSG_STOP) {
+            reactor_stop(reactor);
+        }
+    }
+
+    if (to_draw && reactor->running) {
+        draw_dynamics(state);
+        doupdate();
+    }
+}
+
+// Input period: the parameters are checked, the highlight of the last key
+// expires and a resize of the terminal is noticed
+static void on_timer(struct reactor *reactor, void *context, bool signaled) {
+    struct input_state *state = context;
+    uint64_t expirations;
+    if (!signaled ||
+        read(state->timer_fd, &expirations, sizeof(expirations)) < 0)
+        return;
+
+    // Update parameters when the counter reaches zero. The file is parsed
+    // only if it changed, the parameters are replaced all together only if
+    // the input section is valid.
+    if (!state->reading_params_interval--) {
+        if (config_changed(&state->config_watch) &&
+            config_load_input(&state->params))
+            logging("INFO", "Updated input parameters at runtime.");
+
+        state->reading_params_interval =
+            round(state->params.reading_params_interval / INPUT_PERIOD);
     }
 
-    // Clamp force components within the maximum limits
-    if (to_update->x_component > max_force) to_update->x_component = max_force;
-    if (to_update->y_component > max_force) to_update->y_component = max_force;
-    if (to_update->x_component < -max_force) to_update->x_component = -max_force;
-    if (to_update->y_component < -max_force) to_update->y_component = -max_force;
+    // Remove the highlight of the last key once its period is over
+    if (state->highlight_periods > 0 && --state->highlight_periods == 0) {
+        state->highlighted = ERR;
+        draw_controls(state);
+        doupdate();
+    }
 
-    return ret;
+    // A resize is reported by getch, which is not called without keys
+    on_keys(reactor, context, false);
 }
 
 int main(int argc, char *argv[]) {
@@ -138,10 +391,11 @@ int main(int argc, char *argv[]) {
     HANDLE_WATCHDOG_SIGNALS();
 
     // Validate and parse input arguments
-    int server_write_pipe, server_read_pipe;
-    if (argc == 3) {
-        sscanf(argv[1], "%d", &server_write_pipe);   // Extract the "to server" pipe
-        sscanf(argv[2], "%d", &server_read_pipe); // Extract the "from server" pipe
+    int server_write_efd, requests_efd, telemetry_efd;
+    if (argc == 4) {
+        sscanf(argv[1], "%d", &server_write_efd); // Doorbell of the "to server" ring
+        sscanf(argv[2], "%d", &requests_efd); // Rings of the telemetry slot
+        sscanf(argv[3], "%d", &telemetry_efd);
     } else {
         printf("Error: Incorrect number of arguments provided.\n");
         getchar();
@@ -162,15 +416,39 @@ int main(int argc, char *argv[]) {
     Write(fd, input_pid_str, strlen(input_pid_str) + 1);
     Close(fd);
 
+    static struct input_state state;
 
-    // Retrieve configuration values
-    float max_force = get_param("input", "max_force");   // Max force applied per axis
-    float force_step = get_param("input", "force_step"); // Force increment per key press
-
-    // Initialize drone parameters (force, velocity, position)
-    struct force drone_force = {0, 0};
-    struct velocity drone_velocity = {0, 0};
-    struct pos drone_position = {0, 0};
+    // Retrieve configuration values: max_force is the max force applied per
+    // axis, force_step the force increment per key press. The file is parsed
+    // again only when it is modified.
+    if (!config_load_input(&state.params)) {
+        printf("Input: Error - Invalid config file\n");
+        getchar();
+        exit(1);
+    }
+    config_watch_init(&state.config_watch);
+
+    // The interval for reading parameters from the file, converted to input
+    // periods
+    state.reading_params_interval =
+        round(state.params.reading_params_interval / INPUT_PERIOD);
+
+    // Only the number of drones is read from the blackboard
+    state.bb          = blackboard_open();
+    state.highlighted = ERR;
+
+    // Forces are sent to the server through a shared memory ring, the drone
+    // dynamics and the score are pushed by the server when they change
+    struct channel_table *channels = channels_open();
+    channel_attach(&state.to_server, &channels->rings[CH_INPUT_SERVER],
+                   server_write_efd);
+    channel_attach(&state.telemetry_requests,
+                   &channels->telemetry_requests[TELEMETRY_INPUT],
+                   requests_efd);
+    channel_attach(&state.telemetry,
+                   &channels->telemetry_streams[TELEMETRY_INPUT],
+                   telemetry_efd);
+    subscribe(&state);
 
     // Initialize ncurses for UI rendering
     initscr();
@@ -178,213 +456,46 @@ int main(int argc, char *argv[]) {
     noecho();      // Prevent typed characters from appearing on the screen
     curs_set(0);   // Hide cursor for better UI experience
     start_color(); // Enable color support
+    nodelay(stdscr, TRUE); // Keys are read only when stdin is readable
 
     // Use terminal's default background color
     use_default_colors();
     init_pair(1, COLOR_GREEN, -1); // Green for active input
     init_pair(2, COLOR_RED, -1);   // Red for warnings/errors
 
-
-    // The windows of the matrix visible in the left split are now initialized
-    WINDOW *control_window  = input_display_setup(LINES, COLS / 2 - 1, 0, 0);
-    WINDOW *info_window = input_display_setup(LINES, COLS / 2 - 1, COLS / 2, 0);
-    WINDOW *tl_win      = input_display_setup(5, 7, LINES / 3, COLS / 6);
-    WINDOW *tc_win      = input_display_setup(5, 7, LINES / 3, COLS / 6 + 6);
-    WINDOW *tr_win      = input_display_setup(5, 7, LINES / 3, COLS / 6 + 12);
-    WINDOW *cl_win      = input_display_setup(5, 7, LINES / 3 + 4, COLS / 6);
-    WINDOW *cc_win = input_display_setup(5, 7, LINES / 3 + 4, COLS / 6 + 6);
-    WINDOW *cr_win = input_display_setup(5, 7, LINES / 3 + 4, COLS / 6 + 12);
-    WINDOW *bl_win = input_display_setup(5, 7, LINES / 3 + 8, COLS / 6);
-    WINDOW *bc_win = input_display_setup(5, 7, LINES / 3 + 8, COLS / 6 + 6);
-    WINDOW *br_win = input_display_setup(5, 7, LINES / 3 + 8, COLS / 6 + 12);
-
-    // Variable to store user input
-    char input;
-
-    // Set the interval for reading parameters from the file (converted to loop cycles)
-    int reading_params_interval = round(get_param("input", "reading_params_interval") / 0.1);
-
-    // Ensure the interval is at least 1 to avoid excessive file reads
-    if (reading_params_interval < 1)
-        reading_params_interval = 1;
-
-    // Set timeout for non-blocking input (100ms equivalent to usleep(100000))
-    timeout(100);
-
-    // Initialize file descriptor sets for monitoring input from the server
-    fd_set reader, master;
-    FD_ZERO(&reader);
-    FD_ZERO(&master);
-    FD_SET(server_read_pipe, &master);
-
-    // Buffer for message storage
-    char server_response[MAX_MSG_LEN];
-
-    while (1) {
-        // Update parameters when the counter reaches zero
-        if (!reading_params_interval--) {
-            reading_params_interval = round(get_param("input", "reading_params_interval") / 0.1);
-            if (reading_params_interval < 1) 
-                reading_params_interval = 1;
-
-            force_step = get_param("input", "force_step");
-            max_force  = get_param("input", "max_force");
-
-            logging("INFO", "Updated input parameters at runtime.");
-        }
-
-        // Capture user input if available
-        input = getch();
-
-        // If 'p' is pressed, signal termination to the server and exit
-        if (input == 'p') {
-            Write(server_write_pipe, "STOP", MAX_MSG_LEN);
-            break;
-        }
-
-        // Compute the drone's force based on user input
-        bool to_update = update_force(&drone_force, input, force_step, max_force);
-
-        // If the force was updated, send the new force values to the server
-        if (to_update) {
-            char force_message[MAX_STR_LEN];
-            sprintf(force_message, "%f|%f", drone_force.x_component, drone_force.y_component);
-            Write(server_write_pipe, force_message, MAX_MSG_LEN);
-            logging("INFO", "Sent updated input force to the server");
-        }
-
-        // Request an update from the server
-        Write(server_write_pipe, "U", MAX_MSG_LEN);
-
-        // Read the updated position and velocity from the server
-        if (Read(server_read_pipe, server_response, MAX_MSG_LEN) == 0)
-            break;
-        sscanf(server_response, "%f,%f|%f,%f", &drone_position.x, &drone_position.y,
-               &drone_velocity.x_component, &drone_velocity.y_component);
-
-        // Refresh display by destroying and recreating windows
-        destroy_input_display(tl_win);
-        destroy_input_display(control_window);
-        destroy_input_display(info_window);
-
-        // Initialize left and right display splits
-        control_window  = input_display_setup(LINES, COLS / 2 - 1, 0, 0);
-        info_window = input_display_setup(LINES, COLS / 2 - 1, 0, COLS / 2);
-
-        // Initialize arrow key display windows in a 3x3 grid
-        tl_win = input_display_setup(5, 7, LINES / 4, COLS / 6);
-        tc_win = input_display_setup(5, 7, LINES / 4, COLS / 6 + 6);
-        tr_win = input_display_setup(5, 7, LINES / 4, COLS / 6 + 12);
-        cl_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6);
-        cc_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6 + 6);
-        cr_win = input_display_setup(5, 7, LINES / 4 + 4, COLS / 6 + 12);
-        bl_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6);
-        bc_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6 + 6);
-        br_win = input_display_setup(5, 7, LINES / 4 + 8, COLS / 6 + 12);
-
-        // Set titles for display sections
-        mvwprintw(control_window, 0, 1, "INPUT DISPLAY");
-        mvwprintw(info_window, 0, 1, "DYNAMICS DISPLAY");
-
-        // Highlight the pressed key
-        begin_format_input(input, tl_win, tc_win, tr_win, cl_win, cc_win,
-                           cr_win, bl_win, bc_win, br_win);
-
-        /// Drawing ASCII arrows
-        // Upward arrows
-        mvwprintw(tl_win, 1, 3, "_");  // Top-left
-        mvwprintw(tl_win, 2, 2, "'\\");
-        mvwprintw(tc_win, 1, 3, "A");  // Top-center
-        mvwprintw(tc_win, 2, 3, "|");
-        mvwprintw(tr_win, 1, 3, "_");  // Top-right
-        mvwprintw(tr_win, 2, 3, "/'");
-
-        // Left and right arrows
-        mvwprintw(cl_win, 2, 2, "<");  // Left
-        mvwprintw(cl_win, 2, 3, "-");
-        mvwprintw(cr_win, 2, 3, "-");  // Right
-        mvwprintw(cr_win, 2, 4, ">");
-
-        // Downward arrows
-        mvwprintw(bl_win, 2, 2, "|/"); // Bottom-left
-        mvwprintw(bl_win, 3, 2, "'-");
-        mvwprintw(bc_win, 2, 3, "|");  // Bottom-center
-        mvwprintw(bc_win, 3, 3, "V");
-        mvwprintw(br_win, 2, 3, "\\|"); // Bottom-right
-        mvwprintw(br_win, 3, 3, "-'");
-
-        // Stop symbol (brake)
-        mvwprintw(cc_win, 2, 3, "X");
-
-        // Reset color for the next iteration
-        end_format_input(input, tl_win, tc_win, tr_win, cl_win, cc_win, cr_win,
-                         bl_win, bc_win, br_win);
-
-        /// Setting corner symbols in the matrix
-        mvwprintw(tc_win, 0, 0, ".");  // Top border corners
-        mvwprintw(tr_win, 0, 0, ".");
-        mvwprintw(cl_win, 0, 0, "+");  // Middle section corners
-        mvwprintw(cc_win, 0, 0, "+");
-        mvwprintw(cr_win, 0, 0, "+");
-        mvwprintw(cr_win, 0, 6, "+");
-        mvwprintw(bl_win, 0, 0, "+");  // Bottom border corners
-        mvwprintw(bc_win, 0, 0, "+");
-        mvwprintw(br_win, 0, 0, "+");
-        mvwprintw(br_win, 0, 6, "+");
-        mvwprintw(bc_win, 4, 0, "'");  // Bottom edge symbols
-        mvwprintw(br_win, 4, 0, "'");
-
-        // Display instruction to exit
-        mvwprintw(control_window, LINES - 3, 3, "Press 'p' to exit");
-
-        /// Right Panel - Display Drone Information
-
-        // Display drone position
-        mvwprintw(info_window, LINES / 10 + 2, COLS / 10, "Position {");
-        mvwprintw(info_window, LINES / 10 + 3, COLS / 10, "\tx: %f", drone_position.x);
-        mvwprintw(info_window, LINES / 10 + 4, COLS / 10, "\ty: %f", drone_position.y);
-        mvwprintw(info_window, LINES / 10 + 5, COLS / 10, "}");
-
-        // Display drone velocity
-        mvwprintw(info_window, LINES / 10 + 7, COLS / 10, "Velocity {");
-        mvwprintw(info_window, LINES / 10 + 8, COLS / 10, "\tx: %f", drone_velocity.x_component);
-        mvwprintw(info_window, LINES / 10 + 9, COLS / 10, "\ty: %f", drone_velocity.y_component);
-        mvwprintw(info_window, LINES / 10 + 10, COLS / 10, "}");
-
-        // Display the force currently applied by the user on the drone.
-        // External effects (e.g., borders) are not considered in these values.
-        mvwprintw(info_window, LINES / 10 + 12, COLS / 10, "Force {");
-
-        // Highlight force values in red if they reach the maximum limit
-        if (fabs(drone_force.x_component) == max_force) {
-            wattron(info_window, COLOR_PAIR(2));
-        }
-        mvwprintw(info_window, LINES / 10 + 13, COLS / 10, "\tx: %f", drone_force.x_component);
-        wattroff(info_window, COLOR_PAIR(2));
-
-        if (fabs(drone_force.y_component) == max_force) {
-            wattron(info_window, COLOR_PAIR(2));
-        }
-        mvwprintw(info_window, LINES / 10 + 14, COLS / 10, "\ty: %f", drone_force.y_component);
-        wattroff(info_window, COLOR_PAIR(2));
-
-        // Refresh all windows to update the display
-        wrefresh(control_window);
-        wrefresh(info_window);
-        wrefresh(tl_win);
-        wrefresh(tc_win);
-        wrefresh(tr_win);
-        wrefresh(cl_win);
-        wrefresh(cc_win);
-        wrefresh(cr_win);
-        wrefresh(bl_win);
-        wrefresh(bc_win);
-        wrefresh(br_win);
-    }
+    // The windows are drawn once, then only the parts that change
+    display_build(&state.display);
+    wnoutrefresh(stdscr);
+    draw_controls(&state);
+    draw_dynamics(&state);
+    doupdate();
+
+    // Event loop: keys are handled as soon as they are typed and the
+    // telemetry as soon as it is pushed. The timer only runs the periodic
+    // chores.
+    state.timer_fd = Timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    long period_ns           = INPUT_PERIOD * 1e9;
+    struct itimerspec period = {{0, period_ns}, {0, period_ns}};
+    Timerfd_settime(state.timer_fd, 0, &period, NULL);
+
+    struct reactor reactor;
+    reactor_init(&reactor);
+    reactor_add(&reactor, STDIN_FILENO, on_keys, NULL, &state);
+    reactor_add(&reactor, telemetry_efd, on_telemetry, prepare_telemetry,
+                &state);
+    reactor_add(&reactor, state.timer_fd, on_timer, NULL, &state);
+    reactor_run(&reactor);
 
     // Cleanup and exit
-    Close(server_write_pipe);
-    Close(server_read_pipe);
+    reactor_close(&reactor);
+    Close(state.timer_fd);
+    Close(server_write_efd);
+    Close(requests_efd);
+    Close(telemetry_efd);
+    config_watch_close(&state.config_watch);
+    channels_close(channels);
+    blackboard_close(state.bb);
+    display_destroy(&state.display);
     endwin(); // Close ncurses
     return 0;
-}
\ No newline at end of file
+}
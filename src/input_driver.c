@@ -0,0 +1,73 @@
+#include "config/config.h"
+#include "constants.h"
+#include "controls/controls.h"
+#include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "timing/timing.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+
+// Scripted replacement of the input process used in headless mode. Every
+// character of the script is a key pressed during one input period, '.'
+// meaning no key, exactly as if it was typed in the input window. The
+// simulation is stopped once the script is over.
+int main(int argc, char *argv[]) {
+    // Initialize the watchdog signal handler
+    HANDLE_WATCHDOG_SIGNALS();
+
+    // Validate and parse input arguments
+    int server_write_efd;
+    const char *script;
+    if (argc == 3) {
+        // Doorbell of the "to server" ring and keys to play
+        sscanf(argv[1], "%d", &server_write_efd);
+        script = argv[2];
+    } else {
+        printf("Error: Incorrect number of arguments provided.\n");
+        exit(1);
+    }
+
+    // Communicate the PID to the watchdog process, in place of the input
+    Mkfifo(FIFO2_PATH, 0666);
+    char driver_pid_str[10];
+    sprintf(driver_pid_str, "%d", getpid());
+    int fd = Open(FIFO2_PATH, O_WRONLY);
+    Write(fd, driver_pid_str, strlen(driver_pid_str) + 1);
+    Close(fd);
+
+    // Same force parameters as the interactive input
+    struct input_config params = {0};
+    if (!config_load_input(&params)) {
+        printf("Input driver: Error - Invalid config file\n");
+        exit(1);
+    }
+
+    // Forces are sent to the server through a shared memory ring
+    struct channel_table *channels = channels_open();
+    struct channel to_server;
+    channel_attach(&to_server, &channels->rings[CH_INPUT_SERVER],
+                   server_write_efd);
+
+    struct force drone_force = {0, 0};
+    struct fixed_step clock;
+    fixed_step_init(&clock, INPUT_PERIOD, 0);
+
+    for (const char *key = script; *key != '\0' && *key != 'p'; key++) {
+        if (update_force(&drone_force, *key, params.force_step,
+                         params.max_force)) {
+            channel_send(&to_server, MSG_FORCE, &drone_force,
+                         sizeof(drone_force));
+            logging("INFO", "Sent updated input force to the server");
+        }
+        fixed_step_wait(&clock);
+    }
+
+    // The script is over, terminate the simulation
+    logging("INFO", "Input script completed, stopping the simulation");
+    channel_send(&to_server, MSG_STOP, NULL, 0);
+
+    Close(server_write_efd);
+    channels_close(channels);
+    return 0;
+}
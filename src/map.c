@@ -1,118 +1,393 @@
+#include "blackboard/blackboard.h"
+#include "config/config.h"
 #include "constants.h"
 #include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include "render/render.h"
+#include "ring/ring.h"
+#include "scoring/scoring.h"
+#include "timing/timing.h"
 #include "utility/utility.h"
 #include "wrappers/wrappers.h"
 #include <math.h>
 #include <time.h>
-/*
- * Global variables to track screen positions of targets and obstacles.
- * Used to check collisions or overlap with the drone.
- */
-int target_obstacles_screen_position[N_TARGETS + N_OBSTACLES][2];
-int tosp_top = -1; // Tracks the top index of the position array stack.
 
 // Buffer for logging event reasons.
 char event_reason[50] = "";
 
 // Functions
 /*
- * Creates the map window for the simulation.
- * Draws a border around the specified dimensions.
+ * Content of the title line: the score message, its color pair and the time
+ * taken to reach the last target, -1 before the first one.
  */
-WINDOW *create_map_win(int height, int width, int starty, int startx) {
-    WINDOW *local_win = newwin(height, width, starty, startx);
-    box(local_win, 0, 0); // Draws a border around the window.
-    return local_win;
-}
+struct status_line {
+    char text[120];
+    int color;
+    long impact_time;
+};
 
 /*
- * Clears and destroys a specified map window.
- * Useful for refreshing or resizing the map window dynamically.
+ * Draws the title line on stdscr, only when its content changed since the
+ * last frame or the terminal was cleared.
  */
-void destroy_map_win(WINDOW *local_win) {
-    wborder(local_win, ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-            ' ');        // Removes the window border.
-    wrefresh(local_win); // Refreshes the display.
-    delwin(local_win);   // Deletes the window.
+void draw_status(const struct status_line *status, bool cleared) {
+    static struct status_line shown = {"", -1, -1};
+    if (!cleared && status->color == shown.color &&
+        status->impact_time == shown.impact_time &&
+        strcmp(status->text, shown.text) == 0)
+        return;
+    shown = *status;
+
+    move(0, 0);
+    clrtoeol();
+    mvprintw(0, 0, "MAP DISPLAY");
+    attron(COLOR_PAIR(status->color));
+    mvprintw(0, COLS / 5, "%s", status->text);
+    attroff(COLOR_PAIR(status->color));
+    if (status->impact_time >= 0)
+        mvprintw(0, 4 * COLS / 5, "%ld", status->impact_time);
 }
 
 /*
- * Checks if a given position (x, y) overlaps with the drone or other
- * targets/obstacles. Also ensures the position is within the valid display
- * boundaries.
+ * Scoring state of the map. Targets are hit in simulation coordinates at the
+ * physics rate, whatever the size of the terminal and the frame rate, and in
+ * the same way with and without a terminal.
  */
-bool is_overlapping(int y, int x, int *drone_y, int *drone_x) {
-    if (y < 1 || x < 1 || y > LINES - 3 || x > COLS - 2)
-        return true; // Out of bounds.
-
-    // Check if it overlaps with the drone's position.
-    if (drone_y != NULL && drone_x != NULL && *drone_y == y && *drone_x == x)
-        return true;
-
-    // Check for overlap with targets or obstacles.
-    for (int i = 0; i <= tosp_top; i++) {
-        if (y == target_obstacles_screen_position[i][0] &&
-            x == target_obstacles_screen_position[i][1])
-            return true;
+struct map_state {
+    struct score_keeper keeper;
+    int published_score;
+    struct pos targets_pos[N_TARGETS];
+    int target_num;
+    struct pos obstacles_pos[N_OBSTACLES];
+    int obstacles_num;
+
+    // Position of each drone at the previous scoring step, the start of the
+    // segment it travelled since then
+    struct pos last_pos[MAX_DRONES];
+
+    // Last scoring event, shown on the title line: the score increment and
+    // the time taken to reach the last target, -1 before the first one
+    int score_increment;
+    long impact_time;
+};
+
+void map_state_init(struct map_state *state, struct blackboard *bb) {
+    scoring_init(&state->keeper, time(NULL));
+    state->published_score = 0;
+    state->target_num      = 0;
+    state->obstacles_num   = 0;
+    state->score_increment = 0;
+    state->impact_time     = -1;
+
+    struct drone_state drone_state;
+    for (int id = 0; id < bb->drone_count; id++) {
+        BB_SNAPSHOT_DRONE(bb, id, &drone_state);
+        state->last_pos[id] = drone_state.position;
     }
-    return false;
 }
 
 /*
- * Finds a valid position around a given (old_y, old_x).
- * Expands outward in a square pattern until a valid spot is found.
+ * Drains every frame relayed by the server since the previous step without
+ * blocking, only the latest targets and obstacles are kept. The ring is
+ * polled, so the server never rings the doorbell. Returns false once STOP is
+ * received.
  */
-void find_spot(int *old_y, int *old_x, int drone_y, int drone_x) {
-    for (int index = 1;; index++) { // Expands the search radius indefinitely.
-        int x = *old_x, y = *old_y;
-
-        // Check the row above.
-        y = *old_y - index;
-        for (x = *old_x - index; x <= *old_x + index; x++) {
-            if (!is_overlapping(y, x, &drone_y, &drone_x)) {
-                *old_y = y;
-                *old_x = x;
-                return;
-            }
+bool ingest(struct map_state *state, struct channel *from_server,
+            struct blackboard *bb) {
+    struct msg received;
+    char aux[100];
+    while (channel_recv(from_server, &received)) {
+        switch (received.header.type) {
+            case MSG_STOP:
+                return false;
+            case MSG_OBSTACLES:
+                // Arrival of new obstacle data
+                state->obstacles_num = received.payload.set.count;
+                memcpy(state->obstacles_pos, received.payload.set.items,
+                       state->obstacles_num * sizeof(struct pos));
+                sprintf(aux, "Total obstacles updated: %d",
+                        state->obstacles_num);
+                logging("INFO", aux);
+                break;
+            case MSG_TARGETS:
+                // Arrival of new target data
+                state->target_num = received.payload.set.count;
+                memcpy(state->targets_pos, received.payload.set.items,
+                       state->target_num * sizeof(struct pos));
+                sprintf(aux, "Total targets updated: %d", state->target_num);
+                logging("INFO", aux);
+                // Update target spawn time
+                scoring_new_targets(&state->keeper, time(NULL));
+                BB_PUBLISH(bb, targets, &received.payload.set);
+                break;
         }
+    }
+    return true;
+}
 
-        // Check the row below.
-        y = *old_y + index;
-        for (x = *old_x - index; x <= *old_x + index; x++) {
-            if (!is_overlapping(y, x, &drone_y, &drone_x)) {
-                *old_y = y;
-                *old_x = x;
-                return;
-            }
+/*
+ * Scoring step, run at the physics rate. Each drone is followed along the
+ * segment from its previous position to the current one, so a target is hit
+ * even if the drone moved past it between two steps. The map notifies the
+ * hits to the server on behalf of the drone, and publishes the remaining
+ * targets and the score.
+ */
+void score_step(struct map_state *state, struct channel *to_server,
+                struct blackboard *bb) {
+    struct drone_state drone_state;
+    bool to_decrease = false;
+
+    for (int id = 0; id < bb->drone_count; id++) {
+        BB_SNAPSHOT_DRONE(bb, id, &drone_state);
+        struct pos from = state->last_pos[id];
+        struct pos to   = drone_state.position;
+
+        state->last_pos[id] = to;
+
+        int i;
+        while ((i = find_swept_hit(state->targets_pos, state->target_num,
+                                   from, to, HIT_RADIUS)) >= 0) {
+            // Calculate time taken to reach the target
+            state->impact_time =
+                time(NULL) - (time_t)state->keeper.targets_time;
+
+            // Update score and last target hit time
+            state->score_increment =
+                scoring_target_hit(&state->keeper, i, time(NULL));
+
+            // Event message on the screen
+            snprintf(event_reason, sizeof(event_reason),
+                     "You reached target %d! You got", i + 1);
+
+            // Notify server of target hit, on behalf of the drone
+            struct target_hit hit = {i, state->targets_pos[i]};
+            remove_target(i, state->targets_pos, state->target_num);
+            channel_send_to(to_server, id, MSG_TARGET_HIT, &hit, sizeof(hit));
+            state->target_num--;
+            to_decrease = true;
         }
 
-        // Check the column to the left.
-        x = *old_x - index;
-        for (y = *old_y - index + 1; y <= *old_y + index - 1; y++) {
-            if (!is_overlapping(y, x, &drone_y, &drone_x)) {
-                *old_y = y;
-                *old_x = x;
-                return;
-            }
+        // --- Wall Collision Logic ---
+        // If the drone touches the simulation boundaries, decrease score.
+        // Prevent frequent deductions—only decrease score once every
+        // WALL_PENALTY_PERIOD seconds
+        if (scoring_wall(&state->keeper, to, time(NULL))) {
+            state->score_increment = -1;
+
+            // Update event log message
+            snprintf(event_reason, sizeof(event_reason),
+                     "You hit the wall! You lost 1 point.");
         }
+    }
 
-        // Check the column to the left.
-        x = *old_x - index;
-        for (y = *old_y - index + 1; y <= *old_y + index - 1; y++) {
-            if (!is_overlapping(y, x, &drone_y, &drone_x)) {
-                *old_y = y;
-                *old_x = x;
-                return;
-            }
-        }
+    // Check if any targets were hit
+    if (to_decrease) {
+        // If all targets have been hit, request new ones from the server
+        if (state->target_num == 0)
+            channel_send(to_server, MSG_GENERATE, NULL, 0);
+
+        // Publish the remaining targets
+        struct entity_set targets_set;
+        targets_set.count = state->target_num;
+        memcpy(targets_set.items, state->targets_pos,
+               state->target_num * sizeof(struct pos));
+        BB_PUBLISH(bb, targets, &targets_set);
+    }
 
-        // If the index grows too large, assume no valid position is available.
-        if (index > 100) {
-            logging("ERROR",
-                    "Unable to find a valid position for map display.");
-            exit(EXIT_FAILURE);
-        }
+    // Publish the score only when it changes
+    if (state->keeper.score != state->published_score) {
+        char aux[100];
+        sprintf(aux, "Score updated: %d", state->keeper.score);
+        logging("INFO", aux);
+        BB_PUBLISH(bb, score, &state->keeper.score);
+        state->published_score = state->keeper.score;
+    }
+}
+
+/*
+ * Draws a frame: the targets, the obstacles and the drones at their latest
+ * position, and the title line. Nothing is decided here, the scoring only
+ * depends on the simulation.
+ */
+void draw_frame(struct renderer *render, const struct map_state *state,
+                struct blackboard *bb) {
+    // The latest state of every drone is taken from the blackboard, a
+    // torn-free snapshot with no syscall involved
+    struct drone_state drone_state;
+    struct pos drones_pos[MAX_DRONES];
+    int drone_count = bb->drone_count;
+    for (int id = 0; id < drone_count; id++) {
+        BB_SNAPSHOT_DRONE(bb, id, &drone_state);
+        drones_pos[id] = drone_state.position;
+    }
+
+    // Start a new frame, the window is rebuilt only if the terminal was
+    // resized
+    render_begin(render);
+    WINDOW *map_window         = render->win;
+    struct occupancy *occupied = &render->occupied;
+
+    // Convert the drone's simulated position (500x500 grid) to the terminal
+    // window scale. The mapping maintains proportionality between simulation
+    // and display dimensions.
+    //
+    // Adjustments:
+    // - The window has borders, so we subtract 2 from width/height.
+    // - An extra -1 ensures the correct index range, as array indices start
+    // at 0.
+    //
+    // Formula:
+    // drone_position_in_terminal = (simulated_drone_position * (window_size
+    // - border_offset)) / SIMULATION_SIZE
+
+    int drones_x[MAX_DRONES], drones_y[MAX_DRONES];
+    for (int id = 0; id < drone_count; id++) {
+        drones_x[id] = round(1 + drones_pos[id].x * (getmaxx(map_window) - 3) /
+                                     SIMULATION_WIDTH);
+        drones_y[id] = round(1 + drones_pos[id].y * (getmaxy(map_window) - 3) /
+                                     SIMULATION_HEIGHT);
+    }
+
+    // Targets and obstacles are moved away from the first drone only, if
+    // there is one. Its cell is computed apart so that it never depends on
+    // the loop above having run.
+    int drone_x = -1, drone_y = -1;
+    if (drone_count > 0) {
+        drone_x = round(1 + drones_pos[0].x * (getmaxx(map_window) - 3) /
+                                SIMULATION_WIDTH);
+        drone_y = round(1 + drones_pos[0].y * (getmaxy(map_window) - 3) /
+                                SIMULATION_HEIGHT);
+    }
+
+    int target_x, target_y;
+    for (int i = 0; i < state->target_num; i++) {
+        // Convert target's simulated position to fit terminal window
+        // dimensions
+        target_x = round(1 + state->targets_pos[i].x *
+                                 (getmaxx(map_window) - 3) / SIMULATION_WIDTH);
+        target_y = round(1 + state->targets_pos[i].y *
+                                 (getmaxy(map_window) - 3) / SIMULATION_HEIGHT);
+
+        // Ensure no overlap with other objects. If the terminal is too small
+        // for every entity, the target is not drawn in this frame.
+        if (occupancy_taken(occupied, target_y, target_x) &&
+            !occupancy_find_free(occupied, &target_y, &target_x, drone_y,
+                                 drone_x))
+            continue;
+
+        // Store target position for collision checking
+        occupancy_take(occupied, target_y, target_x);
+
+        // Render the target on the map
+        render_put(render, target_y, target_x, ('1' + i) | COLOR_PAIR(3));
+    }
+
+    int obst_x, obst_y;
+
+    // Boolean flag to determine if the drone should be displayed or if it
+    // appears to be overlapping an obstacle. Due to the simulation's 500x500
+    // resolution being scaled down for the terminal window, visual overlaps
+    // may occur. However, this does not mean the drone is actually colliding
+    // with obstacles in the simulation.
+    //
+    // Adjusting obstacle positions to avoid this issue is not ideal, as users
+    // may resize the terminal to a small window, causing the same visual
+    // effect.
+    bool can_display_drone[MAX_DRONES];
+    for (int id = 0; id < drone_count; id++)
+        can_display_drone[id] = true;
+
+    for (int i = 0; i < state->obstacles_num; i++) {
+        // Convert obstacle position from simulation space (500x500) to
+        // terminal coordinates.
+        obst_x = round(1 + state->obstacles_pos[i].x *
+                               (getmaxx(map_window) - 3) / SIMULATION_WIDTH);
+        obst_y = round(1 + state->obstacles_pos[i].y *
+                               (getmaxy(map_window) - 3) / SIMULATION_HEIGHT);
+
+        // Check for overlap with existing targets, obstacles, or the drone
+        // itself, and find an alternative position. The obstacle is not
+        // drawn if the terminal is full.
+        if ((occupancy_taken(occupied, obst_y, obst_x) ||
+             (obst_y == drone_y && obst_x == drone_x)) &&
+            !occupancy_find_free(occupied, &obst_y, &obst_x, drone_y,
+                                 drone_x))
+            continue;
+
+        // Store the obstacle position for future collision checks.
+        occupancy_take(occupied, obst_y, obst_x);
+
+        // Render the obstacle on the map.
+        render_put(render, obst_y, obst_x, 'O' | COLOR_PAIR(2));
+
+        // If a drone's position matches an obstacle, prevent it from being
+        // displayed.
+        for (int id = 0; id < drone_count; id++)
+            if (obst_y == drones_y[id] && obst_x == drones_x[id])
+                can_display_drone[id] = false;
+    }
+
+    // Render the drones not visually overlapping an obstacle.
+    for (int id = 0; id < drone_count; id++)
+        if (can_display_drone[id])
+            render_put(render, drones_y[id], drones_x[id],
+                       '+' | COLOR_PAIR(1));
+
+    // Display the current score and event messages: green for a positive
+    // score, red for a negative one
+    static struct status_line status = {"Start playing the game!", 0, -1};
+    status.impact_time               = state->impact_time;
+    if (state->score_increment > 0) {
+        snprintf(status.text, sizeof(status.text),
+                 "Score: %d | %s +%d points", state->keeper.score,
+                 event_reason, state->score_increment);
+        status.color = 3;
+    } else if (state->score_increment < 0) {
+        snprintf(status.text, sizeof(status.text), "Score: %d | %s -%d point",
+                 state->keeper.score, event_reason, -state->score_increment);
+        status.color = 2;
+    }
+    draw_status(&status, render->resized);
+
+    // Draw only the cells that changed, with a single terminal update
+    render_end(render);
+}
+
+/*
+ * Steps between two checks of the configuration file, at least one
+ */
+int params_interval(float reading_params_interval,
+                    const struct drone_config *drone_params) {
+    int interval = round(reading_params_interval / drone_params->time_step);
+    return interval < 1 ? 1 : interval;
+}
+
+/*
+ * Counts down the steps to the next check of the configuration file, then
+ * reads it if it changed. Both sections are applied together, only if both
+ * are valid, and the clock follows the new time step. Returns true if the
+ * parameters changed.
+ */
+bool reload_params(int *countdown, struct config_watch *config_watch,
+                   struct drone_config *drone_params,
+                   struct map_config *map_params, struct fixed_step *clock) {
+    if ((*countdown)--)
+        return false;
+
+    bool changed = false;
+    struct drone_config new_drone;
+    struct map_config new_map;
+    if (config_changed(config_watch) && config_load_drone(&new_drone) &&
+        config_load_map(&new_map) && new_map.target_fps > 0) {
+        *drone_params = new_drone;
+        *map_params   = new_map;
+        fixed_step_set_period(clock, drone_params->time_step);
+        logging("INFO", "Map has updated its parameters");
+        changed = true;
     }
+    *countdown =
+        params_interval(map_params->reading_params_interval, drone_params);
+    return changed;
 }
 
 // Main function
@@ -123,24 +398,18 @@ void find_spot(int *old_y, int *old_x, int drone_y, int drone_x) {
 int main(int argc, char *argv[]) {
     HANDLE_WATCHDOG_SIGNALS(); // Initialize watchdog signals for safety.
 
-    int to_server, from_server; // Pipes for inter-process communication.
-    if (argc == 3) {
-        sscanf(argv[1], "%d", &to_server);   // Read the server's write pipe.
-        sscanf(argv[2], "%d", &from_server); // Read the server's read pipe.
+    int to_server_efd, from_server_efd; // Doorbells of the rings.
+    bool headless = false;              // Run without rendering.
+    if (argc == 3 || (argc == 4 && strcmp(argv[3], "--headless") == 0)) {
+        sscanf(argv[1], "%d", &to_server_efd);   // Ring towards the server.
+        sscanf(argv[2], "%d", &from_server_efd); // Ring from the server.
+        headless = argc == 4;
     } else {
-        printf("Invalid number of arguments. Expected 2 pipes.\n");
+        printf("Invalid number of arguments. Expected 2 eventfds.\n");
         getchar();
         exit(1);
     }
 
-    // Score tracking.
-    int score = 0, score_increment = 0;
-
-    // Time-related variables.
-    time_t start_time               = 0;
-    time_t last_score_decrease_time = 0;
-    time_t current_time             = time(NULL);
-
     // Setup FIFO communication for watchdog.
     Mkfifo(FIFO1_PATH, 0666);
     int fd = Open(FIFO1_PATH, O_WRONLY);
@@ -148,11 +417,58 @@ int main(int argc, char *argv[]) {
     sprintf(map_pid_str, "%d", getpid());
     Write(fd, map_pid_str, strlen(map_pid_str) + 1);
     Close(fd);
-    // Drone position and other entities.
-    struct pos drone_pos = {INIT_POSE_X, INIT_POSE_Y};
-    struct pos targets_pos[N_TARGETS];
-    struct pos obstacles_pos[N_OBSTACLES];
-    int target_num = 0, obstacles_num = 0;
+    // Map the blackboard holding the drone state, the score and the targets.
+    struct blackboard *bb = blackboard_open();
+
+    // The scoring runs at the physics rate of the drones, the frames are
+    // drawn at the frame rate of the map. Both are read again when the
+    // config file changes.
+    struct drone_config drone_params = {0};
+    struct map_config map_params     = {0};
+    if (!config_load_drone(&drone_params) || !config_load_map(&map_params) ||
+        map_params.target_fps <= 0) {
+        printf("Map: Error - Invalid config file\n");
+        getchar();
+        exit(1);
+    }
+    struct config_watch config_watch;
+    config_watch_init(&config_watch);
+
+    // Score tracking, on the wall clock.
+    static struct map_state state;
+    map_state_init(&state, bb);
+
+    // Attach to the rings shared with the server.
+    struct channel_table *channels = channels_open();
+    struct channel to_server, from_server;
+    channel_attach(&to_server, &channels->rings[CH_MAP_SERVER], to_server_efd);
+    channel_attach(&from_server, &channels->rings[CH_SERVER_MAP],
+                   from_server_efd);
+
+    // Steps are scheduled on absolute deadlines, a late step is run at once
+    // and the missed ones are dropped: the swept hit test covers the whole
+    // distance travelled in the meantime.
+    struct fixed_step clock;
+    fixed_step_init(&clock, drone_params.time_step, 0);
+    int reading_params_interval =
+        params_interval(map_params.reading_params_interval, &drone_params);
+
+    // Without a terminal only the scoring runs
+    if (headless) {
+        while (ingest(&state, &from_server, bb)) {
+            reload_params(&reading_params_interval, &config_watch,
+                          &drone_params, &map_params, &clock);
+            score_step(&state, &to_server, bb);
+            fixed_step_wait(&clock);
+        }
+
+        Close(to_server_efd);
+        Close(from_server_efd);
+        channels_close(channels);
+        blackboard_close(bb);
+        config_watch_close(&config_watch);
+        return EXIT_SUCCESS;
+    }
 
     // Setup ncurses for GUI rendering.
     initscr();
@@ -164,290 +480,47 @@ int main(int argc, char *argv[]) {
     init_pair(2, COLOR_RED, -1);   // Obstacle color.
     init_pair(3, COLOR_GREEN, -1); // Target color.
 
-    // Create the map window.
-    WINDOW *map_window =
-        create_map_win(getmaxy(stdscr) - 2, getmaxx(stdscr), 1, 0);
-
-    char received[MAX_MSG_LEN]; // Buffer for incoming messages.
-    fd_set master, reader;
-    struct timeval select_timeout = {5, 0}; // Timeout for the select() syscall.
-
-    FD_ZERO(&master);
-    FD_SET(from_server, &master);
-    // Monitor for incoming data.
-
-    while (1) {
-        // resetting the fd_set
-        reader = master;
-        int ret;
-        do {
-            // Signals like SIGWINCH (used by ncurses for window resizing) are
-            // not ignored to ensure proper handling. Ignoring or resetting them
-            // would prevent the GUI from resizing correctly.
-            ret = Select(from_server + 1, &reader, NULL, NULL, &select_timeout);
-
-            // Restart Select if interrupted by a signal and SA_RESTART didn't
-            // handle it.
-
-        } while (ret == -1);
-        // Resetting the timeout
-        select_timeout.tv_sec  = 5;
-        select_timeout.tv_usec = 0;
-
-        if (FD_ISSET(from_server, &reader)) {
-            int read_ret = Read(from_server, received, MAX_MSG_LEN);
-
-            // If the pipe is closed, handle cleanup and log the event
-            if (read_ret == 0) {
-                Close(from_server);
-                FD_CLR(from_server, &master);
-                logging("WARN", "Connection to map process lost. Pipe closed.");
-            } else {
-                char aux[100];
-
-                // If "STOP" command is received, exit the loop
-                if (!strcmp(received, "STOP")) {
-                    break;
-                }
-                switch (received[0]) {
-                    case 'D':
-                        // 'D' indicates a drone position update
-                        sscanf(received, "D%f|%f", &drone_pos.x, &drone_pos.y);
-                        break;
-                    case 'O':
-                        // 'O' signals the arrival of new obstacle data
-                        logging("INFO", "Processing new obstacle data...");
-                        tokenization(obstacles_pos, received, &obstacles_num);
-                        sprintf(aux, "Total obstacles updated: %d",
-                                obstacles_num);
-                        logging("INFO", aux);
-                        break;
-                    case 'T':
-                        // 'T' signals the arrival of new target data
-                        logging("INFO", "Processing new target data...");
-                        tokenization(targets_pos, received, &target_num);
-                        sprintf(aux, "Total targets updated: %d", target_num);
-                        logging("INFO", aux);
-                        start_time = time(NULL); // Update target spawn time
-                        break;
-                }
-            }
-        }
-
-        // Refresh the screen to update the display
-        refresh();
-
-        // Display the window title
-        mvprintw(0, 0, "MAP DISPLAY");
-
-        // Clear any extra characters when resizing the window
-        int max_x = COLS;
-        for (int x = 11; x < max_x; x++) {
-            mvaddch(0, x, ' ');
-        }
-
-        // Display the current score and event messages
-        if (score_increment > 0) {
-            attron(COLOR_PAIR(3)); // Green for positive score
-            mvprintw(0, COLS / 5, "Score: %d | %s +%d points", score,
-                     event_reason, score_increment);
-            attroff(COLOR_PAIR(3));
-        } else if (score_increment < 0) {
-            attron(COLOR_PAIR(2)); // Red for negative score
-            mvprintw(0, COLS / 5, "Score: %d | %s -%d point", score,
-                     event_reason, -score_increment);
-            attroff(COLOR_PAIR(2));
-        } else {
-            mvprintw(0, COLS / 5, "Start playing the game!");
-        }
-
-        // Refresh to apply the score updates
-        refresh();
-
-        // Recreate the map window to handle resizing and animations
-        delwin(map_window);
-        map_window = create_map_win(LINES - 1, COLS, 1, 0);
-
-        // Convert the drone's simulated position (500x500 grid) to the terminal
-        // window scale. The mapping maintains proportionality between
-        // simulation and display dimensions.
-        //
-        // Adjustments:
-        // - The window has borders, so we subtract 2 from width/height.
-        // - An extra -1 ensures the correct index range, as array indices start
-        // at 0.
-        //
-        // Formula:
-        // drone_position_in_terminal = (simulated_drone_position * (window_size
-        // - border_offset)) / SIMULATION_SIZE
-
-        int drone_x = round(1 + drone_pos.x * (getmaxx(map_window) - 3) /
-                                    SIMULATION_WIDTH);
-        int drone_y = round(1 + drone_pos.y * (getmaxy(map_window) - 3) /
-                                    SIMULATION_HEIGHT);
-
-        int target_x, target_y;
-        bool to_decrease = false;
-
-        // Get the current time
-        current_time = time(NULL);
-
-        // Last time the score was decreased
-
-        char to_send[MAX_MSG_LEN];
-
-        // Activate color for displaying targets
-        wattron(map_window, COLOR_PAIR(3));
-
-        for (int i = 0; i < target_num; i++) {
-            // Convert target's simulated position to fit terminal window
-            // dimensions
-            target_x = round(1 + targets_pos[i].x * (getmaxx(map_window) - 3) /
-                                     SIMULATION_WIDTH);
-            target_y = round(1 + targets_pos[i].y * (getmaxy(map_window) - 3) /
-                                     SIMULATION_HEIGHT);
-
-            // Ensure no overlap with other objects
-            if (is_overlapping(target_y, target_x, NULL, NULL)) {
-                find_spot(&target_y, &target_x, drone_y, drone_x);
-            }
-            // Check if the drone has reached the target
-            if (target_x == drone_x && target_y == drone_y) {
-                // Calculate time taken to reach the target
-                time_t impact_time = time(NULL) - start_time;
-                start_time         = time(NULL);
-                mvprintw(0, 4 * COLS / 5, "%ld", (long)impact_time);
-
-                // --- Scoring Logic ---
-                // If the target 1 is reached within 20 seconds:
-                // Score increases based on the formula: 20 - time taken
-                // Otherwise, it gives a minimal point increase.
-                if (i == 0) {
-                    score_increment = 4; // Target 1 gives 4 points
-                    if (impact_time < 30) {
-                        score_increment += 30 - (int)ceil(impact_time);
-                    }
-                } else {
-                    score_increment = 2; // Other targets give 2 point
-                }
-
-                // Update score and last target hit time
-                score += score_increment;
-
-                // Event message on the screen
-                snprintf(event_reason, sizeof(event_reason),
-                         "You reached target %d! You got", i + 1);
-
-                // Notify server of target hit
-                sprintf(to_send, "TH|%d|%.3f,%.3f", i, targets_pos[i].x,
-                        targets_pos[i].y);
-                remove_target(i, targets_pos, target_num);
-                Write(to_server, to_send, MAX_MSG_LEN);
-
-                // Mark that a target was removed
-                to_decrease = true;
-            } else {
-                // Store target position for collision checking
-                target_obstacles_screen_position[++tosp_top][0] = target_y;
-                target_obstacles_screen_position[tosp_top][1]   = target_x;
-
-                // Render the target on the map
-                mvwprintw(map_window, target_y, target_x, "%d", i + 1);
-            }
+    // Create the map window, kept between frames. Only the cells that
+    // change are drawn again.
+    static struct renderer render;
+    render_init(&render);
+
+    // Frames have their own clock at the target frame rate of the config
+    // file, whatever the physics rate and the rate of the messages. A late
+    // frame is drawn at once and the missed ones are dropped.
+    struct fixed_step frame_clock;
+    fixed_step_init(&frame_clock, 1.0 / map_params.target_fps, 0);
+
+    while (ingest(&state, &from_server, bb)) {
+        if (fixed_step_due(&clock)) {
+            // Check if it's time to look for changes of the configuration
+            // file
+            if (reload_params(&reading_params_interval, &config_watch,
+                              &drone_params, &map_params, &clock))
+                fixed_step_set_period(&frame_clock,
+                                      1.0 / map_params.target_fps);
+
+            score_step(&state, &to_server, bb);
         }
 
-        // --- Wall Collision Logic ---
-        // If the drone moves outside simulation boundaries, decrease score
-        if (drone_pos.y < 3 || drone_pos.y > SIMULATION_HEIGHT - 3 ||
-            drone_pos.x < 3 || drone_pos.x > SIMULATION_WIDTH - 3) {
-
-            // Prevent frequent deductions—only decrease score once
-            // every 3 seconds
-            current_time = time(NULL);
-            if (difftime(current_time, last_score_decrease_time) > 3) {
-                score_increment = -1;
-                score += score_increment;
-                last_score_decrease_time = current_time;
-
-                // Update event log message
-                snprintf(event_reason, sizeof(event_reason),
-                         "You hit the wall! You lost 1 point.");
-            }
-        }
-
-        // Disable target color after rendering
-        wattroff(map_window, COLOR_PAIR(3));
-
-        // Check if any targets were hit
-        if (to_decrease) {
-            // If all targets have been hit, request new ones from the
-            // server
-            if (--target_num == 0) {
-                Write(to_server, "GE", MAX_MSG_LEN);
-            }
-        }
-
-        int obst_x, obst_y;
-
-        // Boolean flag to determine if the drone should be displayed or if
-        // it appears to be overlapping an obstacle. Due to the simulation's
-        // 500x500 resolution being scaled down for the terminal window,
-        // visual overlaps may occur. However, this does not mean the drone
-        // is actually colliding with obstacles in the simulation.
-        //
-        // Adjusting obstacle positions to avoid this issue is not ideal, as
-        // users may resize the terminal to a small window, causing the same
-        // visual effect.
-        bool can_display_drone = true;
-
-        wattron(map_window, COLOR_PAIR(2));
-        for (int i = 0; i < obstacles_num; i++) {
-            // Convert obstacle position from simulation space (500x500) to
-            // terminal coordinates.
-            obst_x = round(1 + obstacles_pos[i].x * (getmaxx(map_window) - 3) /
-                                   SIMULATION_WIDTH);
-            obst_y = round(1 + obstacles_pos[i].y * (getmaxy(map_window) - 3) /
-                                   SIMULATION_HEIGHT);
-
-            // Check for overlap with existing targets, obstacles, or the
-            // drone itself.
-            if (is_overlapping(obst_y, obst_x, &drone_y, &drone_x)) {
-                find_spot(&obst_y, &obst_x, drone_y,
-                          drone_x); // Find an alternative position.
-            }
-
-            // Store the obstacle position for future collision checks.
-            target_obstacles_screen_position[++tosp_top][0] = obst_y;
-            target_obstacles_screen_position[tosp_top][1]   = obst_x;
-
-            // Render the obstacle on the map.
-            mvwprintw(map_window, obst_y, obst_x, "O");
-
-            // If the drone's position matches an obstacle, prevent it from
-            // being displayed.
-            if (obst_y == drone_y && obst_x == drone_x) {
-                can_display_drone = false;
-            }
-        }
-
-        wattroff(map_window,
-                 COLOR_PAIR(2)); // Disable obstacle color rendering.
-
-        // Render the drone if it is not visually overlapping an obstacle.
-        if (can_display_drone) {
-            wattron(map_window, COLOR_PAIR(1));
-            mvwprintw(map_window, drone_y, drone_x, "+");
-            wattroff(map_window, COLOR_PAIR(1));
-        }
+        // Draw only the cells that changed since the previous frame
+        if (fixed_step_due(&frame_clock))
+            draw_frame(&render, &state, bb);
 
-        // Refresh the map window to reflect updated positions.
-        wrefresh(map_window);
-        tosp_top = -1; // Reset the top index for tracking positions.
+        // Wait for the next step or frame, whichever comes first. Signals
+        // like SIGWINCH (used by ncurses for window resizing) are not
+        // ignored, the sleep is simply resumed and the resize is handled by
+        // the next frame.
+        fixed_step_sleep_first(&clock, &frame_clock);
     }
 
     /// Clean up
-    Close(to_server);
-    Close(from_server);
+    Close(to_server_efd);
+    Close(from_server_efd);
+    channels_close(channels);
+    blackboard_close(bb);
+    render_close(&render);
+    config_watch_close(&config_watch);
     endwin();
     return EXIT_SUCCESS;
 }
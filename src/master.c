@@ -1,6 +1,33 @@
+#include "blackboard/blackboard.h"
 #include "constants.h"
+#include "ring/ring.h"
 #include "wrappers/wrappers.h"
 
+// Closes in a child process the doorbells of the rings it does not use. Since
+// the eventfds are duplicated for each fork, every child keeps only its own.
+// kept_drone is the ID of the drone whose ring is used and kept_client the
+// telemetry slot whose two rings are used, -1 if none.
+static void close_unused_channels(int *channel_efd, const int *used,
+                                  int used_num, int *drone_efd, int drones,
+                                  int kept_drone, int client_efd[][2],
+                                  int kept_client) {
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        bool keep = false;
+        for (int j = 0; j < used_num; j++)
+            keep = keep || used[j] == ch;
+        if (!keep)
+            Close(channel_efd[ch]);
+    }
+    for (int id = 0; id < drones; id++)
+        if (id != kept_drone)
+            Close(drone_efd[id]);
+    for (int slot = 0; slot < TELEMETRY_SLOTS; slot++)
+        if (slot != kept_client) {
+            Close(client_efd[slot][0]);
+            Close(client_efd[slot][1]);
+        }
+}
+
 // Function to spawn a new process and execute a command
 static void spawn(char **exec_args) {
     if (Execvp(exec_args[0], exec_args) == -1) {
@@ -10,9 +37,45 @@ static void spawn(char **exec_args) {
 }
 
 int main(int argc, char *argv[]) {
-    // Specifying that argc and argv are unused variables
-    (void)(argc);
-    (void)(argv);
+    // In headless mode no terminal is opened: the input is replaced by a
+    // driver playing a script of keys and the map only computes the score.
+    // Each drone runs in its own process, or with --fleet all the drones are
+    // stepped by the threads of a single process. With --record a recorder
+    // subscribes to the telemetry and writes it to TELEMETRY_LOG_PATH.
+    // Usage: ./master [--drones N] [--fleet] [--record] [--headless [keys]]
+    bool headless      = false;
+    bool fleet         = false;
+    bool record        = false;
+    char *input_script = HEADLESS_DEFAULT_SCRIPT;
+    int drones         = 1;
+    bool valid         = true;
+    for (int a = 1; a < argc && valid; a++) {
+        if (strcmp(argv[a], "--drones") == 0 && a + 1 < argc) {
+            valid = sscanf(argv[++a], "%d", &drones) == 1;
+        } else if (strcmp(argv[a], "--fleet") == 0) {
+            fleet = true;
+        } else if (strcmp(argv[a], "--record") == 0) {
+            record = true;
+        } else if (strcmp(argv[a], "--headless") == 0) {
+            headless = true;
+            if (a + 1 < argc && strncmp(argv[a + 1], "--", 2) != 0)
+                input_script = argv[++a];
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || drones < 1 || drones > MAX_DRONES) {
+        printf("Usage: %s [--drones N] [--fleet] [--record] [--headless "
+               "[keys]], N from 1 to %d\n",
+               argv[0], MAX_DRONES);
+        exit(EXIT_FAILURE);
+    }
+
+    // The drone processes are spawned right after the server, the other
+    // processes follow in the same order as with a single drone. The
+    // recorder comes last before the watchdog.
+    int drone_procs = fleet ? 1 : drones;
+    int process_num = NUM_PROCESSES + drone_procs - 1 + record;
 
     // Define an array of strings for every process to spawn
     int log_file = creat("../log/process.log", 0666);
@@ -23,314 +86,260 @@ int main(int argc, char *argv[]) {
     }
     logging("INFO", "Beginning of the master process");
 
-    char process_names[NUM_PROCESSES][20];
+    // Create the shared blackboard before any child maps it
+    struct blackboard *bb = blackboard_create(drones);
+
+    char process_names[NUM_PROCESSES + 1][20];
     strcpy(process_names[0], "./server");
     strcpy(process_names[1], "./drone");
-    strcpy(process_names[2], "./input");
+    strcpy(process_names[2], headless ? "./input_driver" : "./input");
     strcpy(process_names[3], "./map");
     strcpy(process_names[4], "./target");
     strcpy(process_names[5], "./obstacle");
     strcpy(process_names[6], "./watchdog");
+    strcpy(process_names[7], "./recorder");
 
     // Array to store child process PIDs
-    pid_t child_pids[NUM_PROCESSES];
+    pid_t child_pids[NUM_PROCESSES + MAX_DRONES];
 
     // Array to store child PIDs as strings (excluding WD)
-    char child_pids_str[NUM_PROCESSES - 1][80];
-
-    // Arrays to contain the pids
-    int server_drone[2];
-    int drone_server[2];
-    int server_input[2];
-    int input_server[2];
-    int map_server[2];
-    int server_map[2];
-    int target_server[2];
-    int server_target[2];
-    int obstacle_server[2];
-    int server_obstacle[2];
-
-    // Creating the pipes
-    Pipe(server_drone);
-    Pipe(drone_server);
-    Pipe(server_input);
-    Pipe(input_server);
-    Pipe(map_server);
-    Pipe(server_map);
-    Pipe(target_server);
-    Pipe(server_target);
-    Pipe(obstacle_server);
-    Pipe(server_obstacle);
-
-    // Strings to pass pipe values as arguments
-    char drone_server_str[10];
-    char server_drone_str[10];
-    char server_input_str[10];
-    char input_server_str[10];
-    char map_server_str[10];
-    char server_map_str[10];
-    char target_server_str[10];
-    char server_target_str[10];
-    char obstacle_server_str[10];
-    char server_obstacle_str[10];
-
-    for (int i = 0; i < NUM_PROCESSES; i++) {
+    char child_pids_str[NUM_PROCESSES + MAX_DRONES - 2][80];
+
+    // Create the shared memory rings replacing the pipes, each with an
+    // eventfd used as doorbell when its consumer is idle
+    struct channel_table *channels = channels_create();
+    int channel_efd[CH_COUNT];
+    for (int ch = 0; ch < CH_COUNT; ch++)
+        channel_efd[ch] = Eventfd(0, EFD_NONBLOCK);
+
+    // Each drone has its own ring coming from the server
+    int drone_efd[MAX_DRONES];
+    for (int id = 0; id < drones; id++)
+        drone_efd[id] = Eventfd(0, EFD_NONBLOCK);
+
+    // Each telemetry client has a ring of requests to the server and a ring
+    // of telemetry coming from it
+    int client_efd[TELEMETRY_SLOTS][2];
+    for (int slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+        client_efd[slot][0] = Eventfd(0, EFD_NONBLOCK);
+        client_efd[slot][1] = Eventfd(0, EFD_NONBLOCK);
+    }
+
+    // Strings to pass eventfd values as arguments
+    char channel_efd_str[CH_COUNT][10];
+    for (int ch = 0; ch < CH_COUNT; ch++)
+        sprintf(channel_efd_str[ch], "%d", channel_efd[ch]);
+    char drone_efd_str[MAX_DRONES][10];
+    for (int id = 0; id < drones; id++)
+        sprintf(drone_efd_str[id], "%d", drone_efd[id]);
+    char client_efd_str[TELEMETRY_SLOTS][2][10];
+    for (int slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+        sprintf(client_efd_str[slot][0], "%d", client_efd[slot][0]);
+        sprintf(client_efd_str[slot][1], "%d", client_efd[slot][1]);
+    }
+
+    for (int i = 0; i < process_num; i++) {
+        // Index of the process in process_names, all the drones share the
+        // same one. The watchdog is always the last process.
+        int role = i == 0 ? 0 : i <= drone_procs ? 1 : i - drone_procs + 1;
+        if (i == process_num - 1)
+            role = 6;
+        else if (record && i == process_num - 2)
+            role = 7;
+
         child_pids[i] = Fork();
         if (!child_pids[i]) {
 
             // Spawn the input and map process using konsole
-            char *exec_args[]        = {process_names[i],
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL,
-                                        NULL};
+            char *exec_args[CH_COUNT + 2 * TELEMETRY_SLOTS + MAX_DRONES + 2] = {
+                process_names[role]};
             char *konsole_arg_list[] = {
-                "konsole", "-e", process_names[i], NULL, NULL, NULL, NULL};
+                "konsole", "-e", process_names[role], NULL, NULL, NULL, NULL};
 
-            switch (i) {
-                case 0:
+            switch (role) {
+                case 0: {
                     // **Server Process Setup**
-                    // Convert pipe file descriptors to strings for argument
-                    // passing.
-                    sprintf(drone_server_str, "%d", drone_server[0]);
-                    sprintf(server_drone_str, "%d", server_drone[1]);
-                    sprintf(input_server_str, "%d", input_server[0]);
-                    sprintf(server_input_str, "%d", server_input[1]);
-                    sprintf(map_server_str, "%d", map_server[0]);
-                    sprintf(server_map_str, "%d", server_map[1]);
-                    sprintf(target_server_str, "%d", target_server[0]);
-                    sprintf(server_target_str, "%d", server_target[1]);
-                    sprintf(obstacle_server_str, "%d", obstacle_server[0]);
-                    sprintf(server_obstacle_str, "%d", server_obstacle[1]);
-
-                    // Assign arguments for the server process
-                    exec_args[1]  = drone_server_str;
-                    exec_args[2]  = server_drone_str;
-                    exec_args[3]  = input_server_str;
-                    exec_args[4]  = server_input_str;
-                    exec_args[5]  = map_server_str;
-                    exec_args[6]  = server_map_str;
-                    exec_args[7]  = target_server_str;
-                    exec_args[8]  = server_target_str;
-                    exec_args[9]  = obstacle_server_str;
-                    exec_args[10] = server_obstacle_str;
-
-                    // **Close unused pipe ends** to prevent resource leaks
-                    Close(drone_server[1]); // Server only reads from drone
-                    Close(server_drone[0]); // Server only writes to drone
-                    Close(input_server[1]);
-                    Close(server_input[0]);
-                    Close(map_server[1]);
-                    Close(server_map[0]);
-                    Close(target_server[1]);
-                    Close(server_target[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
+                    // The server is the other end of every ring, followed by
+                    // the rings of the telemetry clients and of the drones
+                    const int used[] = {CH_INPUT_SERVER,    CH_MAP_SERVER,
+                                        CH_SERVER_MAP,      CH_TARGET_SERVER,
+                                        CH_SERVER_TARGET,   CH_OBSTACLE_SERVER,
+                                        CH_SERVER_OBSTACLE};
+                    for (int j = 0; j < CH_COUNT; j++)
+                        exec_args[j + 1] = channel_efd_str[used[j]];
+                    for (int slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+                        exec_args[CH_COUNT + 1 + 2 * slot] =
+                            client_efd_str[slot][0];
+                        exec_args[CH_COUNT + 2 + 2 * slot] =
+                            client_efd_str[slot][1];
+                    }
+                    for (int id = 0; id < drones; id++)
+                        exec_args[CH_COUNT + 1 + 2 * TELEMETRY_SLOTS + id] =
+                            drone_efd_str[id];
 
                     // Spawn the server process
                     spawn(exec_args);
                     break;
+                }
+
+                case 1: {
+                    if (fleet) {
+                        // **Fleet Process Setup**
+                        // The fleet reads the rings of all the drones, so
+                        // none of their doorbells is closed
+                        exec_args[0] = "./drone_fleet";
+                        for (int id = 0; id < drones; id++)
+                            exec_args[1 + id] = drone_efd_str[id];
+                        close_unused_channels(channel_efd, NULL, 0, drone_efd,
+                                              0, -1, client_efd, -1);
+                        spawn(exec_args);
+                        break;
+                    }
 
-                case 1:
                     // **Drone Process Setup**
-                    sprintf(server_drone_str, "%d", server_drone[0]);
-                    sprintf(drone_server_str, "%d", drone_server[1]);
-
-                    // Assign arguments for the drone process
-                    exec_args[1] = server_drone_str;
-                    exec_args[2] = drone_server_str;
-
-                    // **Close unused pipe ends**
-                    Close(server_drone[1]); // Drone only reads from server
-                    Close(drone_server[0]); // Drone only writes to server
-
-                    // Close all unrelated pipes to avoid interference
-                    Close(server_input[0]);
-                    Close(server_input[1]);
-                    Close(input_server[0]);
-                    Close(input_server[1]);
-                    Close(map_server[0]);
-                    Close(map_server[1]);
-                    Close(server_map[0]);
-                    Close(server_map[1]);
-                    Close(target_server[0]);
-                    Close(target_server[1]);
-                    Close(server_target[0]);
-                    Close(server_target[1]);
-                    Close(obstacle_server[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
-                    Close(server_obstacle[1]);
+                    // The drone state is published on the blackboard, so the
+                    // drone only needs its own ring coming from the server
+                    int id = i - 1;
+                    char id_str[10];
+                    sprintf(id_str, "%d", id);
+                    exec_args[1] = drone_efd_str[id];
+                    exec_args[2] = id_str;
+
+                    // **Close unused doorbells** to avoid interference
+                    close_unused_channels(channel_efd, NULL, 0, drone_efd,
+                                          drones, id, client_efd, -1);
 
                     // Spawn the drone process
                     spawn(exec_args);
                     break;
+                }
 
-                case 2:
+                case 2: {
                     // **Input Process Setup**
-                    // Convert pipe descriptors to strings for argument passing
-                    sprintf(input_server_str, "%d", input_server[1]);
-                    sprintf(server_input_str, "%d", server_input[0]);
-
-                    // Assign pipe arguments for the input process
-                    konsole_arg_list[3] = input_server_str;
-                    konsole_arg_list[4] = server_input_str;
-
-                    // **Close unused pipe ends** for input process
-                    Close(input_server[0]); // Input only writes to the server
-                    Close(server_input[1]); // Input only reads from the server
-
-                    // Close all unrelated pipes
-                    Close(map_server[0]);
-                    Close(map_server[1]);
-                    Close(server_map[0]);
-                    Close(server_map[1]);
-                    Close(target_server[0]);
-                    Close(target_server[1]);
-                    Close(server_target[0]);
-                    Close(server_target[1]);
-                    Close(obstacle_server[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
-                    Close(server_obstacle[1]);
+                    // The drone dynamics come from the telemetry slot of the
+                    // input, which the driver does not use
+                    const int used[]    = {CH_INPUT_SERVER};
+                    konsole_arg_list[3] = channel_efd_str[CH_INPUT_SERVER];
+                    konsole_arg_list[4] = client_efd_str[TELEMETRY_INPUT][0];
+                    konsole_arg_list[5] = client_efd_str[TELEMETRY_INPUT][1];
+
+                    // **Close unused doorbells** for input process
+                    close_unused_channels(channel_efd, used, 1, drone_efd,
+                                          drones, -1, client_efd,
+                                          headless ? -1 : TELEMETRY_INPUT);
+
+                    // Launch the input driver directly in headless mode
+                    if (headless) {
+                        exec_args[1] = channel_efd_str[CH_INPUT_SERVER];
+                        exec_args[2] = input_script;
+                        spawn(exec_args);
+                    }
 
                     // Launch the input process in a new terminal window
                     Execvp("konsole", konsole_arg_list);
                     exit(EXIT_FAILURE);
                     break;
+                }
 
-                case 3:
+                case 3: {
                     // **Map Process Setup**
-                    // Convert pipe descriptors to strings for argument passing
-                    sprintf(map_server_str, "%d", map_server[1]);
-                    sprintf(server_map_str, "%d", server_map[0]);
-
-                    // Assign pipe arguments for the map process
-                    konsole_arg_list[3] = map_server_str;
-                    konsole_arg_list[4] = server_map_str;
-
-                    // **Close unused pipe ends** for map process
-                    Close(map_server[0]); // Map only writes to the server
-                    Close(server_map[1]); // Map only reads from the server
-
-                    // Close all unrelated pipes
-                    Close(target_server[0]);
-                    Close(target_server[1]);
-                    Close(server_target[0]);
-                    Close(server_target[1]);
-                    Close(obstacle_server[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
-                    Close(server_obstacle[1]);
+                    const int used[]    = {CH_MAP_SERVER, CH_SERVER_MAP};
+                    konsole_arg_list[3] = channel_efd_str[CH_MAP_SERVER];
+                    konsole_arg_list[4] = channel_efd_str[CH_SERVER_MAP];
+
+                    // **Close unused doorbells** for map process
+                    close_unused_channels(channel_efd, used, 2, drone_efd,
+                                          drones, -1, client_efd, -1);
+
+                    // Launch the map directly in headless mode
+                    if (headless) {
+                        exec_args[1] = channel_efd_str[CH_MAP_SERVER];
+                        exec_args[2] = channel_efd_str[CH_SERVER_MAP];
+                        exec_args[3] = "--headless";
+                        spawn(exec_args);
+                    }
 
                     // Launch the map process in a new terminal window
                     Execvp("konsole", konsole_arg_list);
                     exit(EXIT_FAILURE);
                     break;
+                }
 
-                case 4:
+                case 4: {
                     // **Target Process Setup**
-                    // Convert pipe descriptors to strings for argument passing
-                    sprintf(target_server_str, "%d", target_server[1]);
-                    sprintf(server_target_str, "%d", server_target[0]);
+                    const int used[] = {CH_TARGET_SERVER, CH_SERVER_TARGET};
+                    exec_args[1]     = channel_efd_str[CH_TARGET_SERVER];
+                    exec_args[2]     = channel_efd_str[CH_SERVER_TARGET];
 
-                    // Assign pipe arguments for the target process
-                    exec_args[1] = target_server_str;
-                    exec_args[2] = server_target_str;
-
-                    // **Close unused pipe ends** for the target process
-                    Close(target_server[0]); // Target only writes to the server
-                    Close(
-                        server_target[1]); // Target only reads from the server
-
-                    // Close all unrelated pipes (Obstacle-related)
-                    Close(obstacle_server[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
-                    Close(server_obstacle[1]);
+                    // **Close unused doorbells** for the target process
+                    close_unused_channels(channel_efd, used, 2, drone_efd,
+                                          drones, -1, client_efd, -1);
 
                     // Spawn the target process
                     spawn(exec_args);
                     break;
+                }
 
-                case 5:
+                case 5: {
                     // **Obstacle Process Setup**
-                    // Convert pipe descriptors to strings for argument passing
-                    sprintf(obstacle_server_str, "%d", obstacle_server[1]);
-                    sprintf(server_obstacle_str, "%d", server_obstacle[0]);
+                    const int used[] = {CH_OBSTACLE_SERVER, CH_SERVER_OBSTACLE};
+                    exec_args[1]     = channel_efd_str[CH_OBSTACLE_SERVER];
+                    exec_args[2]     = channel_efd_str[CH_SERVER_OBSTACLE];
 
-                    // Assign pipe arguments for the obstacle process
-                    exec_args[1] = obstacle_server_str;
-                    exec_args[2] = server_obstacle_str;
-
-                    // **Close unused pipe ends** for the obstacle process
-                    Close(obstacle_server[0]); // Obstacle only writes to the
-                                               // server
-                    Close(server_obstacle[1]); // Obstacle only reads from the
-                                               // server
+                    // **Close unused doorbells** for the obstacle process
+                    close_unused_channels(channel_efd, used, 2, drone_efd,
+                                          drones, -1, client_efd, -1);
 
                     // Spawn the obstacle process
                     spawn(exec_args);
                     break;
+                }
+
+                case 7: {
+                    // **Recorder Process Setup**
+                    // The recorder only uses its telemetry slot, and stops
+                    // if the server is gone
+                    char server_pid_str[10];
+                    sprintf(server_pid_str, "%d", child_pids[0]);
+                    exec_args[1] = client_efd_str[TELEMETRY_RECORDER][0];
+                    exec_args[2] = client_efd_str[TELEMETRY_RECORDER][1];
+                    exec_args[3] = server_pid_str;
+
+                    // **Close unused doorbells** for the recorder process
+                    close_unused_channels(channel_efd, NULL, 0, drone_efd,
+                                          drones, -1, client_efd,
+                                          TELEMETRY_RECORDER);
+
+                    // Spawn the recorder process
+                    spawn(exec_args);
+                    break;
+                }
             }
             //  Spawn the last process: Watchdog (WD), which monitors all other
             //  processes
-            if (i == NUM_PROCESSES - 1) {
-                for (int i = 0; i < NUM_PROCESSES - 1; i++)
-                    sprintf(child_pids_str[i], "%d", child_pids[i]);
-
-                // Sending as arguments to the WD all the processes PIDs
-                char *exec_args[] = {process_names[i],  child_pids_str[0],
-                                     child_pids_str[1], child_pids_str[2],
-                                     child_pids_str[3], child_pids_str[4],
-                                     child_pids_str[5], NULL};
+            if (i == process_num - 1) {
+                // Sending as arguments to the WD all the processes PIDs but
+                // the recorder, which is not monitored
+                for (int j = 0; j < process_num - 1 - record; j++) {
+                    sprintf(child_pids_str[j], "%d", child_pids[j]);
+                    exec_args[j + 1] = child_pids_str[j];
+                }
                 spawn(exec_args);
             }
         } else {
-            // **Parent Process: Close unused pipes**
-            // Since pipes are duplicated for each fork, close unnecessary ones
-            switch (i) {
-                case 1: // **Drone has spawned**
-                    Close(server_drone[0]);
-                    Close(server_drone[1]);
-                    Close(drone_server[0]);
-                    Close(drone_server[1]);
-                    break;
-
-                case 2: // **Input has spawned**
-                    Close(server_input[0]);
-                    Close(server_input[1]);
-                    Close(input_server[0]);
-                    Close(input_server[1]);
-                    break;
-
-                case 3: // **Map has spawned**
-                    Close(server_map[0]);
-                    Close(server_map[1]);
-                    Close(map_server[0]);
-                    Close(map_server[1]);
-                    break;
-
-                case 4: // **Target has spawned**
-                    Close(target_server[0]);
-                    Close(target_server[1]);
-                    Close(server_target[0]);
-                    Close(server_target[1]);
-                    break;
-
-                case 5: // **Obstacle has spawned**
-                    Close(obstacle_server[0]);
-                    Close(obstacle_server[1]);
-                    Close(server_obstacle[0]);
-                    Close(server_obstacle[1]);
-                    break;
+            // **Parent Process: Close the doorbells**
+            // Once the last process using the rings has spawned, the master
+            // does not need them anymore and the watchdog must not inherit
+            // them
+            if (i == process_num - 2) {
+                for (int ch = 0; ch < CH_COUNT; ch++)
+                    Close(channel_efd[ch]);
+                for (int id = 0; id < drones; id++)
+                    Close(drone_efd[id]);
+                for (int slot = 0; slot < TELEMETRY_SLOTS; slot++) {
+                    Close(client_efd[slot][0]);
+                    Close(client_efd[slot][1]);
+                }
             }
         }
     }
@@ -338,25 +347,38 @@ int main(int argc, char *argv[]) {
     // Print PIDs of all spawned processes
     printf("\n--- Process PIDs ---\n");
     printf("Server     PID: %d\n", child_pids[0]);
-    printf("Drone      PID: %d\n", child_pids[1]);
-    printf("Input GUI  PID: %d (Konsole)\n", child_pids[2]);
-    printf("Map GUI    PID: %d (Konsole)\n", child_pids[3]);
-    printf("Target     PID: %d\n", child_pids[4]);
-    printf("Obstacle   PID: %d\n", child_pids[5]);
-    printf("Watchdog   PID: %d\n", child_pids[6]);
+    if (fleet)
+        printf("Fleet      PID: %d (%d drones)\n", child_pids[1], drones);
+    else
+        for (int id = 0; id < drones; id++)
+            printf("Drone %-4d PID: %d\n", id, child_pids[1 + id]);
+    if (headless) {
+        printf("Input drv  PID: %d\n", child_pids[drone_procs + 1]);
+        printf("Map        PID: %d (headless)\n", child_pids[drone_procs + 2]);
+    } else {
+        printf("Input GUI  PID: %d (Konsole)\n", child_pids[drone_procs + 1]);
+        printf("Map GUI    PID: %d (Konsole)\n", child_pids[drone_procs + 2]);
+    }
+    printf("Target     PID: %d\n", child_pids[drone_procs + 3]);
+    printf("Obstacle   PID: %d\n", child_pids[drone_procs + 4]);
+    if (record)
+        printf("Recorder   PID: %d\n", child_pids[drone_procs + 5]);
+    printf("Watchdog   PID: %d\n", child_pids[process_num - 1]);
     printf("---------------------\n\n");
 
     // Value for waiting for the children to terminate
     int exit_status;
 
     // Retrieve and display the exit status of the terminated process
-    for (int i = 0; i < NUM_PROCESSES; i++) {
+    for (int i = 0; i < process_num; i++) {
         int ret = Wait(&exit_status);
         // Getting the exit status
         int status = 0;
         WEXITSTATUS(status);
         printf("Process %d terminated with code: %d\n", ret, status);
     }
+    channels_destroy(channels);
+    blackboard_destroy(bb);
     close(log_file);
 
     return EXIT_SUCCESS;
@@ -1,111 +1,92 @@
+#include "blackboard/blackboard.h"
 #include "constants.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "spawn/spawn.h"
 #include "utility/utility.h"
 #include "wrappers/wrappers.h"
 #include <time.h>
 
-char server_message[MAX_MSG_LEN];
+struct msg server_message;
 
 int main(int argc, char *argv[]) {
     // Initialize signal handlers for watchdog monitoring.
     HANDLE_WATCHDOG_SIGNALS();
 
-    // Variables for server communication pipes.
-    int to_server_pipe, from_server_pipe;
+    // Doorbells of the rings shared with the server.
+    int to_server_efd, from_server_efd;
 
-    // Validate command-line arguments: Expecting exactly 2 pipes.
+    // Validate command-line arguments: Expecting exactly 2 eventfds.
     if (argc == 3) {
-        sscanf(argv[1], "%d", &to_server_pipe);
-        sscanf(argv[2], "%d", &from_server_pipe);
+        sscanf(argv[1], "%d", &to_server_efd);
+        sscanf(argv[2], "%d", &from_server_efd);
     } else {
         printf("Error: Invalid number of arguments in obstacles\n");
         getchar();  
         exit(1);
     }
 
-    // Obstacle-related Variables
-    float obstacle_pos_x, obstacle_pos_y;  // Coordinates for obstacles.
+    // Set of obstacles sent to the server
+    struct entity_set obstacles;
 
-    // Server Communication Buffers
-    char obstacle_data[MAX_MSG_LEN] = "O";  // Message identifier for obstacles.
-    char formatted_message[MAX_MSG_LEN] = {0};  // Buffer for composing messages.
+    // The obstacle process is the only writer of the obstacles on the
+    // blackboard
+    struct blackboard *bb = blackboard_open();
 
     // Random Number Generator Initialization
     // Seeds the generator with the current time (multiplied by 33 for variation),
     // ensuring different obstacle positions across program executions.
-    srandom((unsigned int)time(NULL) * 33);
+    unsigned int seed = (unsigned int)time(NULL) * 33;
 
-    // File Descriptor Sets for Monitoring Pipes
-    fd_set read_fds, master_fds;
-    FD_ZERO(&read_fds);
-    FD_ZERO(&master_fds);
-    FD_SET(from_server_pipe, &master_fds);
+    // Attach to the rings shared with the server.
+    struct channel_table *channels = channels_open();
+    struct channel to_server, from_server;
+    channel_attach(&to_server, &channels->rings[CH_OBSTACLE_SERVER],
+                   to_server_efd);
+    channel_attach(&from_server, &channels->rings[CH_SERVER_OBSTACLE],
+                   from_server_efd);
 
-    // Timeout Settings for Select()
+    // Timeout Settings for the wait on the server ring
     struct timeval select_timeout;
     select_timeout.tv_sec = OBSTACLES_SPAWN_PERIOD;
     select_timeout.tv_usec = 0;
 
     while (1) {
-        // Generate and format a new set of obstacle coordinates to send to the server.
+        // Generate a new set of obstacle coordinates to send to the server.
+        // Random obstacle coordinates within the simulation boundaries.
+        spawn_entities(&obstacles, N_OBSTACLES, &seed);
 
-        // Start message with obstacle count in protocol format: "[N]"
-        sprintf(formatted_message, "[%d]", N_OBSTACLES);
-        strcat(obstacle_data, formatted_message);
-
-        for (int i = 0; i < N_OBSTACLES; i++) {
-            if (i != 0) {
-                strcat(obstacle_data, "|");  // Separate multiple obstacles with "|"
-            }
-
-            // Generate random obstacle coordinates within the simulation boundaries.
-            obstacle_pos_x = random() % SIMULATION_WIDTH;
-            obstacle_pos_y = random() % SIMULATION_HEIGHT;
-
-            // Format as "x,y" with three decimal places.
-            sprintf(formatted_message, "%.3f,%.3f", obstacle_pos_x, obstacle_pos_y);
-            strcat(obstacle_data, formatted_message);
-        }
-
-        // Send the formatted message to the server.
-        Write(to_server_pipe, obstacle_data, MAX_MSG_LEN);
-
-        // Reset message buffer for the next iteration.
-        sprintf(obstacle_data, "O");
+        // Send the new set to the server.
+        channel_send(&to_server, MSG_OBSTACLES, &obstacles,
+                     ENTITY_SET_SIZE(obstacles.count));
+        BB_PUBLISH(bb, obstacles, &obstacles);
 
         // Log successful obstacle generation.
         logging("INFO", "Obstacles process generated a new set of obstacles");
 
-        // Reset the file descriptor set for the next select() call.
-        read_fds = master_fds;
-
-        int select_result;
+        // Wait for a message from the server until the spawn period expires.
+        // select() stores the remaining time in the timeout, so an
+        // interrupted wait is resumed for the time left.
+        bool ready;
         do {
-            select_result = Select(from_server_pipe + 1, &read_fds, NULL, NULL, &select_timeout);
-        } while (select_result == -1);  // Retry if select() is interrupted.
+            ready = channel_wait(&from_server, &select_timeout);
+        } while (!ready && (select_timeout.tv_sec || select_timeout.tv_usec));
 
         // Reset timeout for the next iteration.
         select_timeout.tv_sec  = OBSTACLES_SPAWN_PERIOD;
         select_timeout.tv_usec = 0;
 
-        // Check if there is data to read from the server.
-        if (FD_ISSET(from_server_pipe, &read_fds)) {
-            int read_ret = Read(from_server_pipe, server_message, MAX_MSG_LEN);
-
-            if (read_ret == 0) {
-                // If the pipe is closed, remove it from the set and log the event.
-                Close(from_server_pipe);
-                FD_CLR(from_server_pipe, &master_fds);
-                logging("WARN", "Pipe to obstacles closed");
-            }
-
-            // If the received message is "STOP", terminate the process.
-            if (!strcmp(server_message, "STOP")) {
-                break;
-            }
+        // If the received message is "STOP", terminate the process.
+        if (ready && channel_recv(&from_server, &server_message) &&
+            server_message.header.type == MSG_STOP) {
+            break;
         }
     }
 
     // Cleanup before exiting
-    Close(to_server_pipe);
+    Close(to_server_efd);
+    Close(from_server_efd);
+    channels_close(channels);
+    blackboard_close(bb);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "constants.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <time.h>
+
+// Returns the monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Writes a telemetry frame as a CSV line: the time since the start, the
+// topic, then its values
+static void record(FILE *file, double time, const struct msg *frame) {
+    switch (frame->header.type) {
+        case MSG_DRONE_STATE: {
+            const struct drone_state *state = &frame->payload.state;
+            fprintf(file, "%.3f,drone,%u,%f,%f,%f,%f\n", time,
+                    frame->header.drone, state->position.x, state->position.y,
+                    state->velocity.x_component, state->velocity.y_component);
+            break;
+        }
+        case MSG_TARGETS:
+        case MSG_OBSTACLES:
+            fprintf(file, "%.3f,%s,%u\n", time,
+                    frame->header.type == MSG_TARGETS ? "targets" : "obstacles",
+                    frame->payload.set.count);
+            break;
+        case MSG_SCORE:
+            fprintf(file, "%.3f,score,%d\n", time, frame->payload.score);
+            break;
+    }
+}
+
+// Telemetry client writing every topic of every drone to TELEMETRY_LOG_PATH.
+// It is a passive observer not monitored by the watchdog: it stops when the
+// server ends the stream, or when the server is gone.
+int main(int argc, char *argv[]) {
+    // Validate input arguments and extract the doorbells of the rings
+    int to_server_efd, from_server_efd, server_pid;
+    if (argc == 4) {
+        sscanf(argv[1], "%d", &to_server_efd);
+        sscanf(argv[2], "%d", &from_server_efd);
+        sscanf(argv[3], "%d", &server_pid);
+    } else {
+        printf("Error: Incorrect number of arguments in recorder process\n");
+        exit(1);
+    }
+
+    FILE *file = fopen(TELEMETRY_LOG_PATH, "w");
+    if (!file) {
+        perror("Error creating telemetry log");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(file, "time,topic,values\n");
+
+    // Attach to the telemetry slot of the recorder
+    struct channel_table *channels = channels_open();
+    struct channel to_server, from_server;
+    channel_attach(&to_server,
+                   &channels->telemetry_requests[TELEMETRY_RECORDER],
+                   to_server_efd);
+    channel_attach(&from_server,
+                   &channels->telemetry_streams[TELEMETRY_RECORDER],
+                   from_server_efd);
+
+    struct subscription subscription = {
+        TOPIC_DRONE_STATE | TOPIC_TARGETS | TOPIC_OBSTACLES | TOPIC_SCORE,
+        RECORDER_PERIOD_US, DRONE_ALL};
+    channel_send(&to_server, MSG_SUBSCRIBE, &subscription,
+                 sizeof(subscription));
+    logging("INFO", "Recorder subscribed to the telemetry");
+
+    double start = now();
+    struct msg frame;
+    bool running = true;
+    while (running) {
+        // Sleep on the doorbell, checking once per second that the server
+        // is still there
+        struct timeval timeout = {1, 0};
+        if (!channel_wait(&from_server, &timeout)) {
+            running = kill(server_pid, 0) == 0;
+            continue;
+        }
+
+        while (running && channel_recv(&from_server, &frame)) {
+            if (frame.header.type == MSG_STOP)
+                running = false;
+            else
+                record(file, now() - start, &frame);
+        }
+    }
+
+    // Cleaning up
+    fclose(file);
+    Close(to_server_efd);
+    Close(from_server_efd);
+    channels_close(channels);
+
+    return 0;
+}
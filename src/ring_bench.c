@@ -0,0 +1,94 @@
+#include "constants.h"
+#include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "utility/utility.h"
+#include "wrappers/wrappers.h"
+#include <time.h>
+
+// Default number of force frames sent on each path
+#define BENCH_MESSAGES 1000000
+
+// Returns the monotonic time in seconds
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Sends the frames through a pipe with send_msg/recv_msg, as the processes did
+// before the rings were introduced. Returns the elapsed time.
+static double bench_pipe(long messages) {
+    int pipe_fd[2];
+    Pipe(pipe_fd);
+    struct force force = {1, 1};
+
+    double start = now();
+    if (Fork() == 0) {
+        // Consumer
+        Close(pipe_fd[1]);
+        struct msg received;
+        for (long i = 0; i < messages; i++)
+            recv_msg(pipe_fd[0], &received);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Producer
+    Close(pipe_fd[0]);
+    for (long i = 0; i < messages; i++)
+        send_msg(pipe_fd[1], MSG_FORCE, &force, sizeof(force));
+    Wait(NULL);
+    double elapsed = now() - start;
+    Close(pipe_fd[1]);
+    return elapsed;
+}
+
+// Sends the frames through a shared memory ring, the consumer sleeps on the
+// eventfd only when the ring is empty. Returns the elapsed time.
+static double bench_ring(long messages) {
+    struct spsc_ring *ring = Mmap(NULL, sizeof(struct spsc_ring),
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ring_init(ring);
+    struct channel ch;
+    channel_attach(&ch, ring, Eventfd(0, EFD_NONBLOCK));
+    struct force force = {1, 1};
+
+    double start = now();
+    if (Fork() == 0) {
+        // Consumer
+        struct msg received;
+        for (long i = 0; i < messages;) {
+            if (channel_recv(&ch, &received))
+                i++;
+            else
+                channel_wait(&ch, NULL);
+        }
+        exit(EXIT_SUCCESS);
+    }
+
+    // Producer
+    for (long i = 0; i < messages; i++)
+        channel_send(&ch, MSG_FORCE, &force, sizeof(force));
+    Wait(NULL);
+    double elapsed = now() - start;
+    Close(ch.efd);
+    Munmap(ring, sizeof(struct spsc_ring));
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    // Optionally take the number of messages from the command line
+    long messages = BENCH_MESSAGES;
+    if (argc == 2)
+        sscanf(argv[1], "%ld", &messages);
+
+    double pipe_time = bench_pipe(messages);
+    double ring_time = bench_ring(messages);
+
+    printf("Messages per path: %ld\n", messages);
+    printf("Pipe path: %12.0f msg/s\n", messages / pipe_time);
+    printf("Ring path: %12.0f msg/s\n", messages / ring_time);
+    printf("Speedup:   %12.2fx\n", pipe_time / ring_time);
+    return EXIT_SUCCESS;
+}
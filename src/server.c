@@ -1,32 +1,170 @@
+#include "blackboard/blackboard.h"
 #include "constants.h"
 #include "droneDataStructs.h"
+#include "protocol/protocol.h"
+#include "reactor/reactor.h"
+#include "relay/relay.h"
+#include "ring/ring.h"
+#include "routing/routing.h"
+#include "telemetry/telemetry.h"
 #include "utility/utility.h"
 #include "wrappers/wrappers.h"
 
+// Rings written by the server. Each drone and the map are fed through a
+// coalescing relay, the other processes only receive rare events. The
+// telemetry clients are fed from the blackboard by their own publisher.
+struct server {
+    int drones;
+    struct channel to_drones[MAX_DRONES];
+    struct channel to_map;
+    struct channel to_target;
+    struct channel to_obstacle;
+    struct channel to_clients[TELEMETRY_SLOTS];
+    struct relay drone_relays[MAX_DRONES];
+    struct relay map_relay;
+    struct telemetry telemetry[TELEMETRY_SLOTS];
+};
+
+// Ring read by the server and the component writing it
+struct source {
+    struct channel channel;
+    struct server *server;
+    enum endpoint from;
+};
+
+// Request ring of a telemetry client and its publisher
+struct client {
+    struct channel requests;
+    struct telemetry *telemetry;
+};
+
+// Delivers a frame to the endpoints chosen by the routing table. Only the
+// newest state is relayed to a drone and the map if several arrive within a
+// period. Frames for the drones go to the drone of their ID, or to all of them
+// for DRONE_ALL.
+static void dispatch(struct reactor *reactor, struct server *server,
+                     enum endpoint from, struct msg *received) {
+    unsigned int to = route_frame(from, received->header.type);
+
+    if (received->header.type == MSG_GENERATE)
+        logging("INFO", "Map requested new targets");
+    else if (received->header.type == MSG_TARGET_HIT)
+        logging("INFO", "Map notified a target hit");
+
+    if (to & ROUTE_TO(EP_DRONE)) {
+        // Only the force is meant for a single drone. A target hit carries the
+        // ID of the drone that hit it, but every drone keeps the same targets.
+        uint32_t drone = received->header.type == MSG_FORCE
+                             ? received->header.drone
+                             : DRONE_ALL;
+        if (drone == DRONE_ALL) {
+            for (int i = 0; i < server->drones; i++)
+                relay_post(&server->drone_relays[i], received);
+        } else if (drone < (uint32_t)server->drones) {
+            relay_post(&server->drone_relays[drone], received);
+        }
+    }
+    if (to & ROUTE_TO(EP_MAP))
+        relay_post(&server->map_relay, received);
+    if (to & ROUTE_TO(EP_OBSTACLE))
+        channel_forward(&server->to_obstacle, received);
+    if (to & ROUTE_TO(EP_TARGET))
+        channel_forward(&server->to_target, received);
+
+    // Terminate the server once STOP is delivered
+    if (received->header.type == MSG_STOP)
+        reactor_stop(reactor);
+}
+
+// Sends the state coalesced by a relay once its period has elapsed
+static void on_relay_timer(struct reactor *reactor, void *context,
+                           bool signaled) {
+    (void)reactor;
+    (void)signaled;
+    relay_expire(context);
+}
+
+// Pushes the telemetry that changed once per period of the subscription
+static void on_telemetry_timer(struct reactor *reactor, void *context,
+                               bool signaled) {
+    (void)reactor;
+    (void)signaled;
+    telemetry_expire(context);
+}
+
+// Marks the ring idle before the reactor sleeps, returns false if a frame is
+// already waiting
+static bool prepare_source(void *context) {
+    struct source *source = context;
+    return channel_prepare_wait(&source->channel);
+}
+
+static bool prepare_client(void *context) {
+    struct client *client = context;
+    return channel_prepare_wait(&client->requests);
+}
+
+// Applies the subscriptions of a telemetry client. They never go through the
+// routing table, so a new client needs no change in dispatch.
+static void on_client_ready(struct reactor *reactor, void *context,
+                            bool signaled) {
+    (void)reactor;
+    struct client *client = context;
+    struct msg received;
+
+    channel_finish_wait(&client->requests, signaled);
+    while (channel_recv(&client->requests, &received))
+        if (received.header.type == MSG_SUBSCRIBE)
+            telemetry_subscribe(client->telemetry,
+                                &received.payload.subscription);
+}
+
+// Consumes the doorbell and drains the whole ring, so that a burst on one
+// source is handled in a single wakeup
+static void on_source_ready(struct reactor *reactor, void *context,
+                            bool signaled) {
+    struct source *source = context;
+    struct msg received;
+
+    channel_finish_wait(&source->channel, signaled);
+    while (reactor->running && channel_recv(&source->channel, &received))
+        dispatch(reactor, source->server, source->from, &received);
+}
+
 int main(int argc, char *argv[]) {
     // Initialize Watchdog Signal Handling
     HANDLE_WATCHDOG_SIGNALS();
 
-    // Pipes for inter-process communication (IPC)
-    int from_drone_pipe, to_drone_pipe;
-    int from_input_pipe, to_input_pipe;
-    int from_map_pipe, to_map_pipe;
-    int from_target_pipe, to_target_pipe;
-    int from_obstacles_pipe, to_obstacle_pipe;
-
-    // Verify Argument Count
-    if (argc == 11) {
-        // Extract pipe file descriptors from command-line arguments
-        sscanf(argv[1], "%d", &from_drone_pipe);
-        sscanf(argv[2], "%d", &to_drone_pipe);
-        sscanf(argv[3], "%d", &from_input_pipe);
-        sscanf(argv[4], "%d", &to_input_pipe);
-        sscanf(argv[5], "%d", &from_map_pipe);
-        sscanf(argv[6], "%d", &to_map_pipe);
-        sscanf(argv[7], "%d", &from_target_pipe);
-        sscanf(argv[8], "%d", &to_target_pipe);
-        sscanf(argv[9], "%d", &from_obstacles_pipe);
-        sscanf(argv[10], "%d", &to_obstacle_pipe);
+    // Eventfds used as doorbells of the shared memory rings
+    int to_drone_efd[MAX_DRONES];
+    int from_input_efd;
+    int from_map_efd, to_map_efd;
+    int from_target_efd, to_target_efd;
+    int from_obstacles_efd, to_obstacle_efd;
+    int from_client_efd[TELEMETRY_SLOTS], to_client_efd[TELEMETRY_SLOTS];
+
+    // The server state is large with many drones, it is kept out of the stack
+    static struct server server;
+
+    // Verify Argument Count: the fixed rings, the two rings of each telemetry
+    // client and one ring per drone
+    int first_drone = 8 + 2 * TELEMETRY_SLOTS;
+    server.drones   = argc - first_drone;
+    if (server.drones >= 1 && server.drones <= MAX_DRONES) {
+        // Extract eventfd file descriptors from command-line arguments
+        sscanf(argv[1], "%d", &from_input_efd);
+        sscanf(argv[2], "%d", &from_map_efd);
+        sscanf(argv[3], "%d", &to_map_efd);
+        sscanf(argv[4], "%d", &from_target_efd);
+        sscanf(argv[5], "%d", &to_target_efd);
+        sscanf(argv[6], "%d", &from_obstacles_efd);
+        sscanf(argv[7], "%d", &to_obstacle_efd);
+        for (int i = 0; i < TELEMETRY_SLOTS; i++) {
+            sscanf(argv[8 + 2 * i], "%d", &from_client_efd[i]);
+            sscanf(argv[9 + 2 * i], "%d", &to_client_efd[i]);
+        }
+        for (int i = 0; i < server.drones; i++)
+            sscanf(argv[first_drone + i], "%d", &to_drone_efd[i]);
     } else {
         // Handle incorrect argument count
         printf("Server: Error - Incorrect number of arguments.\n");
@@ -34,126 +172,99 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
-    // Structures to store drone information
-    struct pos drone_current_pos = {0};
-    struct velocity drone_current_velocity = {0};
-
-    // Buffers for logging and message exchange
-    char received_msg[MAX_MSG_LEN];
-    char msg_to_send[MAX_MSG_LEN];
-
-    // File descriptor sets for monitoring multiple input sources
-    fd_set reader;
-    fd_set master;
-
-    // Initialize file descriptor sets
-    FD_ZERO(&reader);
-    FD_ZERO(&master);
-    FD_SET(from_drone_pipe, &master);
-    FD_SET(from_input_pipe, &master);
-    FD_SET(from_map_pipe, &master);
-    FD_SET(from_obstacles_pipe, &master);
-    FD_SET(from_target_pipe, &master);
-
-    // Determine the highest file descriptor value for select()
-    int max_fd_value = max_of_many(5, from_drone_pipe, from_input_pipe, from_map_pipe,
-                            from_obstacles_pipe, from_target_pipe);  
-
-
-    bool stop_requested = false;
-
-    while (1) {
-        // Reset the file descriptor set for select()
-        reader = master;
-        Select_wmask(max_fd_value + 1, &reader, NULL, NULL, NULL);
-
-        // Process each active file descriptor
-        for (int i = 0; i <= max_fd_value; i++) {
-            if (FD_ISSET(i, &reader)) {
-                int read_bytes = Read(i, received_msg, MAX_MSG_LEN);
-                
-                // Handle closed pipes
-                if (read_bytes == 0) {
-                    printf("Pipe to server closed\n");
-                    Close(i);
-                    FD_CLR(i, &master);
-                    continue;
-                }
-
-                // Process input from different sources
-                if (i == from_input_pipe) {
-                    if (!strcmp(received_msg, "STOP")) {
-                        // Terminate all processes when STOP is received
-                        Write(to_drone_pipe, "STOP", MAX_MSG_LEN);
-                        Write(to_map_pipe, "STOP", MAX_MSG_LEN);
-                        Write(to_obstacle_pipe, "STOP", MAX_MSG_LEN);
-                        Write(to_target_pipe, "STOP", MAX_MSG_LEN);
-                        stop_requested = true;
-                        break;
-                    } else if (!strcmp(received_msg, "U")) {
-                        // Send drone position and velocity to input process
-                        sprintf(msg_to_send, "%f,%f|%f,%f", drone_current_pos.x,
-                                drone_current_pos.y,
-                                drone_current_velocity.x_component,
-                                drone_current_velocity.y_component);
-                        Write(to_input_pipe, msg_to_send, MAX_MSG_LEN);
-                    } else {
-                        // Forward force commands from input to the drone
-                        Write(to_drone_pipe, received_msg, MAX_MSG_LEN);
-                    }
-
-                } else if (i == from_drone_pipe) {
-                    // Receive updated drone position and velocity
-                    sscanf(received_msg, "%f,%f|%f,%f", &drone_current_pos.x,
-                           &drone_current_pos.y,
-                           &drone_current_velocity.x_component,
-                           &drone_current_velocity.y_component);
-                    
-                    // Notify the map about the updated drone position
-                    sprintf(msg_to_send, "D%f|%f", drone_current_pos.x,
-                            drone_current_pos.y);
-                    Write(to_map_pipe, msg_to_send, MAX_MSG_LEN);
-
-                } else if (i == from_map_pipe) {
-                    logging("INFO", received_msg);
-                    
-                    if (!strcmp(received_msg, "GE")) {
-                        // Notify the target process to generate new targets
-                        Write(to_target_pipe, "GE", MAX_MSG_LEN);
-                    } else if (received_msg[0] == 'T' && received_msg[1] == 'H') {
-                        // If a target is hit, inform the drone to update its tracking
-                        Write(to_drone_pipe, received_msg, MAX_MSG_LEN);
-                    }
-
-                } else if (i == from_obstacles_pipe) {
-                    // Forward new obstacles to both map and drone
-                    Write(to_map_pipe, received_msg, MAX_MSG_LEN);
-                    Write(to_drone_pipe, received_msg, MAX_MSG_LEN);
-
-                } else if (i == from_target_pipe) {
-                    // Forward new target updates to both map and drone
-                    Write(to_map_pipe, received_msg, MAX_MSG_LEN);
-                    Write(to_drone_pipe, received_msg, MAX_MSG_LEN);
-                }
-            }
-        }
+    // Attach to the rings replacing the pipes
+    struct channel_table *channels = channels_open();
+    for (int i = 0; i < server.drones; i++) {
+        channel_attach(&server.to_drones[i], &channels->drone_rings[i],
+                       to_drone_efd[i]);
+        relay_init(&server.drone_relays[i], &server.to_drones[i],
+                   RELAY_DRONE_PERIOD_US);
+    }
+    channel_attach(&server.to_map, &channels->rings[CH_SERVER_MAP],
+                   to_map_efd);
+    channel_attach(&server.to_target, &channels->rings[CH_SERVER_TARGET],
+                   to_target_efd);
+    channel_attach(&server.to_obstacle, &channels->rings[CH_SERVER_OBSTACLE],
+                   to_obstacle_efd);
+    relay_init(&server.map_relay, &server.to_map, RELAY_MAP_PERIOD_US);
+
+    // Telemetry clients subscribe on their request ring and receive the
+    // sections of the blackboard they asked for on their stream ring
+    struct blackboard *bb = blackboard_open();
+    struct client clients[TELEMETRY_SLOTS];
+    for (int i = 0; i < TELEMETRY_SLOTS; i++) {
+        channel_attach(&server.to_clients[i], &channels->telemetry_streams[i],
+                       to_client_efd[i]);
+        telemetry_init(&server.telemetry[i], &server.to_clients[i], bb);
+        channel_attach(&clients[i].requests, &channels->telemetry_requests[i],
+                       from_client_efd[i]);
+        clients[i].telemetry = &server.telemetry[i];
+    }
 
-        // Exit the loop if a STOP signal was received
-        if (stop_requested)
-            break;
+    // Rings monitored by the server, each one with the component writing it
+    struct source sources[] = {
+        {.server = &server, .from = EP_INPUT},
+        {.server = &server, .from = EP_MAP},
+        {.server = &server, .from = EP_OBSTACLE},
+        {.server = &server, .from = EP_TARGET},
+    };
+    channel_attach(&sources[0].channel, &channels->rings[CH_INPUT_SERVER],
+                   from_input_efd);
+    channel_attach(&sources[1].channel, &channels->rings[CH_MAP_SERVER],
+                   from_map_efd);
+    channel_attach(&sources[2].channel, &channels->rings[CH_OBSTACLE_SERVER],
+                   from_obstacles_efd);
+    channel_attach(&sources[3].channel, &channels->rings[CH_TARGET_SERVER],
+                   from_target_efd);
+    int sources_num = sizeof(sources) / sizeof(sources[0]);
+
+    // Register the doorbells in the reactor. The server may sleep in it
+    // longer than the watchdog period: SIGUSR1 is not masked and an
+    // interrupted wait only leads to a new round.
+    struct reactor reactor;
+    reactor_init(&reactor);
+    for (int i = 0; i < sources_num; i++)
+        reactor_add(&reactor, sources[i].channel.efd, on_source_ready,
+                    prepare_source, &sources[i]);
+    for (int i = 0; i < server.drones; i++)
+        reactor_add(&reactor, server.drone_relays[i].tfd, on_relay_timer, NULL,
+                    &server.drone_relays[i]);
+    reactor_add(&reactor, server.map_relay.tfd, on_relay_timer, NULL,
+                &server.map_relay);
+    for (int i = 0; i < TELEMETRY_SLOTS; i++) {
+        reactor_add(&reactor, clients[i].requests.efd, on_client_ready,
+                    prepare_client, &clients[i]);
+        reactor_add(&reactor, server.telemetry[i].tfd, on_telemetry_timer,
+                    NULL, &server.telemetry[i]);
     }
 
-    // Closing all pipes before terminating the server process
-    Close(from_drone_pipe);
-    Close(from_input_pipe);
-    Close(from_map_pipe);
-    Close(from_obstacles_pipe);
-    Close(from_target_pipe);
-    Close(to_drone_pipe);
-    Close(to_map_pipe);
-    Close(to_obstacle_pipe);
-    Close(to_target_pipe);
-    Close(to_input_pipe);
+    // Dispatch frames until STOP is received
+    reactor_run(&reactor);
+
+    // Closing all doorbells and rings before terminating the server process
+    reactor_close(&reactor);
+    for (int i = 0; i < server.drones; i++) {
+        relay_close(&server.drone_relays[i]);
+        Close(to_drone_efd[i]);
+    }
+    relay_close(&server.map_relay);
+    for (int i = 0; i < TELEMETRY_SLOTS; i++) {
+        // The clients are not in the routing table, they learn the end of
+        // the simulation from their stream
+        telemetry_stop(&server.telemetry[i]);
+        telemetry_close(&server.telemetry[i]);
+        Close(from_client_efd[i]);
+        Close(to_client_efd[i]);
+    }
+    Close(from_input_efd);
+    Close(from_map_efd);
+    Close(from_obstacles_efd);
+    Close(from_target_efd);
+    Close(to_map_efd);
+    Close(to_obstacle_efd);
+    Close(to_target_efd);
+    channels_close(channels);
+    blackboard_close(bb);
 
     return EXIT_SUCCESS;
 }
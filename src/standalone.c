@@ -0,0 +1,92 @@
+#include "config/config.h"
+#include "constants.h"
+#include "controls/controls.h"
+#include "droneDataStructs.h"
+#include "engine/engine.h"
+#include "timing/timing.h"
+#include "utility/utility.h"
+#include <math.h>
+#include <time.h>
+
+// Single process front end of the simulation. The drone, the scoring, the
+// target and obstacle generators and the routing of the server are stepped by
+// direct function calls, with no fork, ring nor signal. Keys are played from a
+// script like in headless mode, one per INPUT_PERIOD of simulated time; with
+// --realtime the steps follow the wall clock, otherwise they run as fast as
+// possible, which is the mode used for profiling.
+int main(int argc, char *argv[]) {
+    bool realtime      = false;
+    const char *script = HEADLESS_DEFAULT_SCRIPT;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--realtime") == 0)
+            realtime = true;
+        else
+            script = argv[i];
+    }
+
+    struct drone_config params = {0};
+    struct input_config input  = {0};
+    if (!config_load_drone(&params) || !config_load_input(&input)) {
+        printf("Standalone: Error - Invalid config file\n");
+        exit(1);
+    }
+
+    static struct engine engine;
+    engine_init(&engine, &params, (unsigned int)time(NULL));
+    logging("INFO", "Standalone simulation started");
+
+    // Period of the input, in steps of the simulated clock
+    long input_period = fmax(round(INPUT_PERIOD / params.time_step), 1);
+
+    struct force drone_force = {0, 0};
+    int published_score      = 0;
+    const char *key          = script;
+
+    struct fixed_step clock;
+    fixed_step_init(&clock, params.time_step, MAX_CATCHUP_STEPS);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (!engine.stopped) {
+        // Input: one key of the script per input period, STOP at its end
+        if (engine.steps % input_period == 0) {
+            if (*key == '\0' || *key == 'p') {
+                engine_send(&engine, EP_INPUT, MSG_STOP, NULL, 0);
+                break;
+            }
+            if (update_force(&drone_force, *key, input.force_step,
+                             input.max_force))
+                engine_send(&engine, EP_INPUT, MSG_FORCE, &drone_force,
+                            sizeof(drone_force));
+            key++;
+        }
+
+        engine_step(&engine);
+
+        // Log the score only when it changes
+        if (engine.keeper.score != published_score) {
+            char aux[100];
+            sprintf(aux, "Score updated: %d", engine.keeper.score);
+            logging("INFO", aux);
+            published_score = engine.keeper.score;
+        }
+
+        if (realtime)
+            fixed_step_wait(&clock);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) +
+                     (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    char aux[200];
+    sprintf(aux,
+            "Standalone: score %d, %d targets hit, %d wall penalties, "
+            "%ld steps (%.1f s simulated) in %.3f s",
+            engine.keeper.score, engine.keeper.targets_hit,
+            engine.keeper.wall_hits, engine.steps, engine.now, elapsed);
+    printf("%s\n", aux);
+    logging("INFO", aux);
+
+    return 0;
+}
@@ -1,4 +1,7 @@
 #include "constants.h"
+#include "protocol/protocol.h"
+#include "ring/ring.h"
+#include "spawn/spawn.h"
 #include "utility/utility.h"
 #include "wrappers/wrappers.h"
 #include <time.h>
@@ -7,59 +10,47 @@ int main(int argc, char *argv[]) {
     // Handle watchdog signals
     HANDLE_WATCHDOG_SIGNALS();
 
-    // Validate input arguments and extract pipe file descriptors
-    int to_server_pipe, from_server_pipe;
+    // Validate input arguments and extract the doorbells of the rings
+    int to_server_efd, from_server_efd;
     if (argc == 3) {
-        sscanf(argv[1], "%d", &to_server_pipe);
-        sscanf(argv[2], "%d", &from_server_pipe);
+        sscanf(argv[1], "%d", &to_server_efd);
+        sscanf(argv[2], "%d", &from_server_efd);
     } else {
         printf("Error: Incorrect number of arguments in target process\n");
         getchar();
         exit(1);
     }
 
-    // Variables for target coordinates
-    float target_pos_x, target_pos_y;
-    
+    // Attach to the rings shared with the server
+    struct channel_table *channels = channels_open();
+    struct channel to_server, from_server;
+    channel_attach(&to_server, &channels->rings[CH_TARGET_SERVER], to_server_efd);
+    channel_attach(&from_server, &channels->rings[CH_SERVER_TARGET],
+                   from_server_efd);
+
     // Buffers for communication with the server
-    char msg_to_send[MAX_MSG_LEN] = "T";  // Message to send targets
-    char aux_to_send[MAX_MSG_LEN] = {0}; // Temporary buffer for formatting
-    char server_response[MAX_MSG_LEN]; // Buffer for received messages
+    struct entity_set targets;  // Set of targets to send
+    struct msg server_response; // Buffer for received frames
 
     // Seed the random number generator with current time for unique results
-    srandom((unsigned int)time(NULL));
+    unsigned int seed = (unsigned int)time(NULL);
 
     while (1) {
-        // Reset target message buffer
-        sprintf(msg_to_send, "T");
-
-        // Format message with number of targets
-        sprintf(aux_to_send, "[%d]", N_TARGETS);
-        strcat(msg_to_send, aux_to_send);
-
-        // Generate random target positions
-        for (int i = 0; i < N_TARGETS; i++) {
-            if (i != 0) strcat(msg_to_send, "|"); // Separate targets with "|"
-
-            // Ensure targets remain within simulation boundaries
-            target_pos_x = random() % SIMULATION_WIDTH;
-            target_pos_y = random() % SIMULATION_HEIGHT;
-
-            // Append formatted target coordinates to message
-            sprintf(aux_to_send, "%.3f,%.3f", target_pos_x, target_pos_y);
-            strcat(msg_to_send, aux_to_send);
-        }
+        // Generate random target positions within simulation boundaries
+        spawn_entities(&targets, N_TARGETS, &seed);
 
         // Send newly generated targets to the server
-        Write(to_server_pipe, msg_to_send, MAX_MSG_LEN);
+        channel_send(&to_server, MSG_TARGETS, &targets,
+                     ENTITY_SET_SIZE(targets.count));
 
-        // Wait for the server’s response (blocking read)
-        Read(from_server_pipe, server_response, MAX_MSG_LEN);
+        // Wait for the server’s response, sleeping on the doorbell
+        while (!channel_recv(&from_server, &server_response))
+            channel_wait(&from_server, NULL);
 
         // Process received server message
-        if (!strcmp(server_response, "GE")) {
+        if (server_response.header.type == MSG_GENERATE) {
             logging("INFO", "Received GE (Generate Event) signal");
-        } else if (!strcmp(server_response, "STOP")) {
+        } else if (server_response.header.type == MSG_STOP) {
             // If STOP signal is received, terminate the process
             break;
         }
@@ -69,7 +60,9 @@ int main(int argc, char *argv[]) {
     }
 
     // Cleaning up
-    Close(to_server_pipe);
+    Close(to_server_efd);
+    Close(from_server_efd);
+    channels_close(channels);
 
     return 0;
 }
@@ -3,8 +3,12 @@
 #include "wrappers/wrappers.h"
 #include <time.h>
 
-// Array to store process PIDs
-int p_pids[NUM_PROCESSES];
+// Array to store process PIDs: input, map, server, target, obstacles and then
+// the drones
+int p_pids[NUM_PROCESSES + MAX_DRONES - 2];
+
+// Number of monitored processes
+int p_num;
 
 // PIDs of konsole processes executing Input and Map
 int konsole_input_pid	, konsole_map_pid	;
@@ -47,14 +51,18 @@ int main(int argc, char *argv[]) {
     // Register signal handler for SIGUSR2
     Sigaction(SIGUSR2, &sa, NULL);
 
-    // Verify the correct number of arguments
-    if (argc == NUM_PROCESSES) {
+    // Verify the correct number of arguments: one PID per drone after the
+    // server one
+    int drones = argc - NUM_PROCESSES + 1;
+    if (drones >= 1 && drones <= MAX_DRONES) {
         sscanf(argv[1], "%d", &p_pids[2]);  // Server PID
-        sscanf(argv[2], "%d", &p_pids[3]);  // Drone PID
-        sscanf(argv[3], "%d", &konsole_input_pid	);  // Konsole running Input
-        sscanf(argv[4], "%d", &konsole_map_pid	);  // Konsole running Map
-        sscanf(argv[5], "%d", &p_pids[4]);  // Target PID
-        sscanf(argv[6], "%d", &p_pids[5]);  // Obstacles PID
+        for (int i = 0; i < drones; i++)
+            sscanf(argv[2 + i], "%d", &p_pids[5 + i]);  // Drone PIDs
+        sscanf(argv[drones + 2], "%d", &konsole_input_pid	);  // Konsole running Input
+        sscanf(argv[drones + 3], "%d", &konsole_map_pid	);  // Konsole running Map
+        sscanf(argv[drones + 4], "%d", &p_pids[3]);  // Target PID
+        sscanf(argv[drones + 5], "%d", &p_pids[4]);  // Obstacles PID
+        p_num = 5 + drones;
     } else {
         perror("Invalid argument list");
         exit(1);
@@ -102,13 +110,14 @@ int main(int argc, char *argv[]) {
 
     while (1) {
         // Iterate over all monitored processes (excluding watchdog itself)
-        for (int i = 0; i < NUM_PROCESSES - 1; i++) {
+        for (int i = 0; i < p_num; i++) {
             // Send SIGUSR1 signal to the process and store the return value
             kill_status	 = Kill2(p_pids[i], SIGUSR1);
 
-            // Log the signal being sent
+            // Log the signal being sent. Pings are debug messages, shown
+            // only when running with LOG_LEVEL=DEBUG.
             sprintf(logmsg, "WD sending signal to process PID: %d", p_pids[i]);
-            logging("INFO", logmsg);
+            LOG_DEBUG(logmsg);
 
             // Handle interruptions in sleep caused by signals
             // sleep() may return early due to a signal, so we retry until the sleep duration is met
@@ -126,7 +135,7 @@ int main(int argc, char *argv[]) {
                 logging("WARN", logmsg);
 
                 // Kill all monitored processes (excluding Konsole processes)
-                for (int i = 0; i < NUM_PROCESSES - 1; i++) {
+                for (int i = 0; i < p_num; i++) {
                     Kill2(p_pids[i], SIGKILL);
                 }
 